@@ -0,0 +1,136 @@
+#include "cowabunga/CBC/Parsers.h"
+#include "cowabunga/CBC/Tokenizers.h"
+#include "cowabunga/Lexer/Lexer.h"
+#include "cowabunga/Lexer/SourceBuffer.h"
+#include "cowabunga/Lexer/StaticLexer.h"
+
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <new>
+#include <string>
+#include <vector>
+
+using namespace cb;
+
+/// Lexes synthetic Cowabunga sources with every lexer configuration and
+/// reports throughput and heap allocations per token. Size of every source in
+/// megabytes may be passed as the argument, default one is 16.
+
+namespace {
+
+std::atomic<size_t> AllocationsNumber{0};
+
+} // namespace
+
+void *operator new(size_t Size) {
+  AllocationsNumber.fetch_add(1, std::memory_order_relaxed);
+  if (void *Memory = std::malloc(Size ? Size : 1)) {
+    return Memory;
+  }
+  throw std::bad_alloc();
+}
+
+void operator delete(void *Memory) noexcept { std::free(Memory); }
+
+void operator delete(void *Memory, size_t) noexcept { std::free(Memory); }
+
+namespace {
+
+struct Workload {
+  const char *Name;
+  std::function<std::string(size_t)> Generate;
+};
+
+/// Repeats Chunk until the source reaches Size bytes.
+std::string repeat(const std::string &Chunk, size_t Size) {
+  std::string Source;
+  Source.reserve(Size + Chunk.length());
+  while (Source.length() < Size) {
+    Source += Chunk;
+  }
+  return Source;
+}
+
+std::vector<Workload> makeWorkloads() {
+  return {
+      {"short lines",
+       [](size_t Size) { return repeat("x = add(y, 1);\nz=x;\n", Size); }},
+      {"huge line",
+       [](size_t Size) {
+         return repeat("value_1 = add(sub(x, 42), y1, 7); ", Size);
+       }},
+      {"deep nesting",
+       [](size_t Size) {
+         std::string Call = "result = ";
+         for (int I = 0; I < 512; ++I) {
+           Call += "add(";
+         }
+         Call += "1";
+         for (int I = 0; I < 512; ++I) {
+           Call += ", 2)";
+         }
+         return repeat(Call + ";\n", Size);
+       }},
+      {"long identifiers",
+       [](size_t Size) {
+         std::string Name(4096, 'v');
+         Name.back() = '1';
+         return repeat(Name + " = " + Name + ";\n", Size);
+       }},
+      {"big integers",
+       [](size_t Size) {
+         std::string Number(1024, '7');
+         return repeat("x = add(" + Number + ", " + Number + ");\n", Size);
+       }},
+  };
+}
+
+template <class TLexer>
+void measure(const char *LexerName, TLexer &Lex,
+             std::shared_ptr<const SourceBuffer> Source) {
+  size_t Bytes = Source->getText().length();
+  size_t AllocationsBefore = AllocationsNumber.load();
+  auto Begin = std::chrono::steady_clock::now();
+  size_t TokensNumber = Lex.tokenize(std::move(Source)).size();
+  auto End = std::chrono::steady_clock::now();
+  size_t Allocations = AllocationsNumber.load() - AllocationsBefore;
+  double Seconds = std::chrono::duration<double>(End - Begin).count();
+  std::cout << "  " << std::left << std::setw(10) << LexerName << std::right
+            << std::setw(10) << TokensNumber << " tokens "
+            << std::setw(12) << TokensNumber / Seconds / 1e6 << " Mtok/s "
+            << std::setw(10) << Bytes / Seconds / (1 << 20) << " MB/s "
+            << std::setw(8)
+            << static_cast<double>(Allocations) / TokensNumber
+            << " allocs/token\n";
+}
+
+} // namespace
+
+int main(int argc, char **argv) {
+  size_t SizeMB = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 16;
+  KeywordSetTokenizer Keywords = createScriptKeywords();
+  Lexer Tokenizers = createScriptLexer();
+  Lexer DFA = Tokenizers;
+  DFA.compile();
+  std::cout << std::fixed << std::setprecision(3);
+  for (auto &Load : makeWorkloads()) {
+    auto Source =
+        SourceBuffer::fromString(Load.Generate(SizeMB << 20), Load.Name);
+    std::cout << Load.Name << " (" << SizeMB << " MB)\n";
+    // Every source is lexed by a fresh copy of the lexer, so that sources of
+    // previous workloads are released.
+    Lexer TokenizersLex = Tokenizers;
+    measure("lexer", TokenizersLex, Source);
+    Lexer DFALex = DFA;
+    measure("dfa", DFALex, Source);
+    StaticLexer<IdentifierTokenizer, IntegralNumberTokenizer,
+                KeywordSetTokenizer>
+        Static(IdentifierTokenizer(), IntegralNumberTokenizer(), Keywords);
+    measure("static", Static, Source);
+  }
+  return 0;
+}
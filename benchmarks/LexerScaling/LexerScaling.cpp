@@ -0,0 +1,105 @@
+#include "cowabunga/CBC/Parsers.h"
+#include "cowabunga/CBC/Tokenizers.h"
+#include "cowabunga/Lexer/Lexer.h"
+#include "cowabunga/Lexer/SourceBuffer.h"
+
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <vector>
+
+using namespace cb;
+
+/// Lexes single-line programs of growing size and fails if lexing time grows
+/// faster than input size. Sizes in megabytes may be passed as arguments,
+/// default ones are 1, 10 and 100.
+
+namespace {
+
+constexpr double MaxGrowthFactor = 2.0;
+
+struct LexerConfig {
+  const char *Name;
+  Lexer Lex;
+};
+
+std::vector<LexerConfig> makeLexerConfigs() {
+  std::vector<LexerConfig> Configs;
+  Lexer Tokenizers;
+  Tokenizers.addTokenizer(IdentifierTokenizer())
+      .addTokenizer(IntegralNumberTokenizer())
+      .addTokenizer(KeywordTokenizer(TID_ExpressionSeparator, ";"))
+      .addTokenizer(KeywordTokenizer(TID_Assignment, "="))
+      .addTokenizer(KeywordTokenizer(TID_OpenParantheses, "("))
+      .addTokenizer(KeywordTokenizer(TID_CloseParantheses, ")"))
+      .addTokenizer(KeywordTokenizer(TID_ArgumentSeparator, ","));
+  Configs.push_back({"tokenizers", Tokenizers});
+  Lexer KeywordSet = createScriptLexer();
+  Configs.push_back({"keyword set", KeywordSet});
+  Lexer DFA = KeywordSet;
+  DFA.compile();
+  Configs.push_back({"dfa", DFA});
+  return Configs;
+}
+
+std::string makeSingleLineProgram(size_t Size) {
+  const std::string Statement = "value_1 = add(sub(x, 42), y1, 7); ";
+  std::string Program;
+  Program.reserve(Size + Statement.length());
+  while (Program.length() < Size) {
+    Program += Statement;
+  }
+  return Program;
+}
+
+double measureSeconds(Lexer &Lex, std::shared_ptr<const SourceBuffer> Source,
+                      size_t &TokensNumber) {
+  auto Begin = std::chrono::steady_clock::now();
+  TokensNumber = Lex.tokenize(std::move(Source)).size();
+  auto End = std::chrono::steady_clock::now();
+  return std::chrono::duration<double>(End - Begin).count();
+}
+
+} // namespace
+
+int main(int argc, char **argv) {
+  std::vector<size_t> SizesMB;
+  for (int I = 1; I < argc; ++I) {
+    SizesMB.push_back(std::strtoull(argv[I], nullptr, 10));
+  }
+  if (SizesMB.empty()) {
+    SizesMB = {1, 10, 100};
+  }
+  auto Configs = makeLexerConfigs();
+  std::vector<std::vector<double>> Seconds(Configs.size());
+  std::cout << std::fixed << std::setprecision(3);
+  for (size_t SizeMB : SizesMB) {
+    auto Source = SourceBuffer::fromString(
+        makeSingleLineProgram(SizeMB << 20), "single-line");
+    for (size_t I = 0; I < Configs.size(); ++I) {
+      size_t TokensNumber = 0;
+      // Tokens are resolved against the Lexer's SourceManager, so use a
+      // fresh copy to avoid keeping every generated source alive.
+      Lexer Lex = Configs[I].Lex;
+      Seconds[I].push_back(measureSeconds(Lex, Source, TokensNumber));
+      std::cout << std::setw(12) << Configs[I].Name << std::setw(6) << SizeMB
+                << " MB " << std::setw(10) << TokensNumber << " tokens "
+                << std::setw(9) << Seconds[I].back() << " s\n";
+    }
+  }
+  int Result = 0;
+  for (size_t I = 0; I < Configs.size(); ++I) {
+    for (size_t J = 1; J < SizesMB.size(); ++J) {
+      double SizeGrowth = static_cast<double>(SizesMB[J]) / SizesMB[J - 1];
+      double TimeGrowth = Seconds[I][J] / Seconds[I][J - 1];
+      if (TimeGrowth > SizeGrowth * MaxGrowthFactor) {
+        std::cerr << Configs[I].Name << ": lexing time grew " << TimeGrowth
+                  << "x while input grew " << SizeGrowth << "x\n";
+        Result = 1;
+      }
+    }
+  }
+  return Result;
+}
@@ -21,6 +21,7 @@ int main() {
   Parser.addCFGRule(SoloNestedRule());
   Parser.addCFGRule(NestedRule());
   Parser.addCFGRule(SequenceRule());
+  Parser.setAlgorithm(cb::CFGParserAlgorithm::Earley);
   Parser.parse(Tokens.cbegin(), Tokens.cend());
   return 0;
 }
\ No newline at end of file
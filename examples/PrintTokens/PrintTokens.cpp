@@ -16,7 +16,8 @@ int main(int argc, char **argv) {
   Script << "a = 13; b = 4;";
   auto Tokens = Lex.tokenize(Script, "stringstream");
   for (const auto &Tok : Tokens) {
-    std::cout << Tok << std::endl;
+    Lex.getSourceManager().print(std::cout, Tok);
+    std::cout << std::endl;
   }
   return 0;
 }
@@ -2,23 +2,40 @@
 #define COWABUNGA_CBC_ASTBUILDER_H
 
 #include "cowabunga/CBC/ASTNodes.h"
+#include "cowabunga/Lexer/SourceManager.h"
+#include "cowabunga/Lexer/SymbolTable.h"
 #include "cowabunga/Lexer/Token.h"
 
 #include <memory>
 #include <stack>
+#include <string_view>
 #include <vector>
 
 namespace cb {
 
+/// ASTBuilder builds nodes from rules applied in the streaming order of
+/// CFGParser: children of a node are built from left to right before it.
 class ASTBuilder final {
 public:
+  /// Identifiers are interned into SymbolTableRef, which has to outlive the
+  /// built AST. Calls should come from a parser in
+  /// CFGParserActionMode::Streaming, see createScriptParser. In the replay
+  /// order, which builds children from right to left, operands of
+  /// assignments are swapped and statements are reversed.
+  ASTBuilder(const SourceManager &SourceManagerRef,
+             SymbolTable &SymbolTableRef);
+
   void createVariable(const Token &Tok);
 
   void createIntegralNumber(const Token &Tok);
 
-  void createCompoundExpression(std::string ExpressionSeparator);
+  /// Makes all nodes built so far statements of a compound expression, in
+  /// order they have been built.
+  void createCompoundExpression(std::string_view ExpressionSeparator);
 
-  void createAssignmentExpression(std::string Assignment);
+  /// Makes the last two built nodes the left and the right operand of an
+  /// assignment.
+  void createAssignmentExpression(std::string_view Assignment);
 
   void createParameterList();
 
@@ -28,6 +45,8 @@ public:
 
   std::unique_ptr<IASTNode> release();
 private:
+  const SourceManager &Sources;
+  SymbolTable &Symbols;
   std::stack<std::vector<std::unique_ptr<IASTNode>>> CreatedParameterLists;
   std::vector<std::unique_ptr<IASTNode>> CreatedExpressions;
 };
@@ -4,18 +4,22 @@
 #include "cowabunga/CBC/Tokenizers.h"
 #include "cowabunga/Common/IClonableMixin.h"
 #include "cowabunga/Common/IPrintable.h"
+#include "cowabunga/Lexer/SymbolTable.h"
 
 #include <memory>
 #include <ostream>
 #include <string>
+#include <string_view>
 #include <vector>
 
 namespace cb {
 
-class Token;
-
 class IASTPass;
 
+/// AST nodes own text of numbers and keyword lexemes. Names of variables and
+/// called functions are interned: passes compare and index them by symbol ID,
+/// and the name itself views the SymbolTable the AST was built with, which
+/// has to outlive the AST.
 class IASTNode : public IPrintable {
 public:
   virtual void acceptASTPass(IASTPass &Pass) = 0;
@@ -27,19 +31,20 @@ public:
 
 class VariableASTNode final : public IClonableMixin<IASTNode, VariableASTNode> {
 public:
-  VariableASTNode(const Token &Tok);
+  VariableASTNode(SymbolTable::ID VariableSymbol, std::string_view VariableName);
 
   void acceptASTPass(IASTPass &Pass) override;
 
   void print(std::ostream &Out) const override;
 
-  std::string Name;
+  SymbolTable::ID Symbol;
+  std::string_view Name;
 };
 
 class IntegralNumberASTNode final
     : public IClonableMixin<IASTNode, IntegralNumberASTNode> {
 public:
-  IntegralNumberASTNode(const Token &Tok);
+  IntegralNumberASTNode(std::string NumberValue);
 
   void acceptASTPass(IASTPass &Pass) override;
 
@@ -96,8 +101,9 @@ public:
 class CallExpressionASTNode final
     : public IClonableMixin<IASTNode, CallExpressionASTNode> {
 public:
-  CallExpressionASTNode(const Token &Tok,
-                            std::vector<std::unique_ptr<IASTNode>> ParamList);
+  CallExpressionASTNode(SymbolTable::ID FunctionSymbol,
+                        std::string_view FunctionName,
+                        std::vector<std::unique_ptr<IASTNode>> ParamList);
 
   CallExpressionASTNode(const CallExpressionASTNode &RHS);
 
@@ -113,7 +119,8 @@ public:
   void print(std::ostream &Out) const override;
 
   std::vector<std::unique_ptr<IASTNode>> Parameters;
-  std::string FuncName;
+  SymbolTable::ID FuncSymbol;
+  std::string_view FuncName;
 };
 
 } // namespace cb
@@ -2,12 +2,13 @@
 #define COWABUNGA_CBC_ASTPASSES_H
 
 #include "cowabunga/CBC/ASTNodes.h"
+#include "cowabunga/Lexer/SymbolTable.h"
 
 #include <llvm/IR/IRBuilder.h>
 #include <llvm/IR/LLVMContext.h>
 
 #include <ostream>
-#include <unordered_map>
+#include <vector>
 
 namespace cb {
 
@@ -47,9 +48,33 @@ private:
   size_t Depth = 0;
 };
 
+/// ASTSymbolRemapper moves an AST to another SymbolTable: symbol I becomes
+/// NewSymbols[I] and names refer to Symbols, the table of the new IDs.
+class ASTSymbolRemapper final : public IASTPass {
+public:
+  ASTSymbolRemapper(const SymbolTable &Symbols,
+                    const std::vector<SymbolTable::ID> &NewSymbols);
+
+  void accept(VariableASTNode &Node) override;
+
+  void accept(IntegralNumberASTNode &Node) override;
+
+  void accept(AssignmentExpressionASTNode &Node) override;
+
+  void accept(CompoundExpressionASTNode &Node) override;
+
+  void accept(CallExpressionASTNode &Node) override;
+
+private:
+  const SymbolTable &Symbols;
+  const std::vector<SymbolTable::ID> &NewSymbols;
+};
+
 class ASTCodeGen final : public IASTPass {
 public:
-  ASTCodeGen();
+  /// Symbols has to be the table the AST was built with. Intrinsic names are
+  /// interned into it.
+  ASTCodeGen(SymbolTable &Symbols);
 
   void accept(VariableASTNode &Node) override;
 
@@ -69,15 +94,20 @@ private:
 
   llvm::Value *codeGenSubstractionIntrinsic(std::vector<llvm::Value *> Params);
 
+  using IntrinsicHandler =
+      llvm::Value *(ASTCodeGen::*)(std::vector<llvm::Value *>);
+
+  void addIntrinsic(SymbolTable &Symbols, std::string_view Name,
+                    IntrinsicHandler Handler);
+
   llvm::LLVMContext Context;
   llvm::Module MainModule;
   llvm::IRBuilder<> Builder;
-  std::unordered_map<std::string,
-                     llvm::Value *(ASTCodeGen::*)(std::vector<llvm::Value *>)>
-      Intrinsics;
+  /// Both tables are indexed by symbol ID, nullptr means no entry.
+  std::vector<IntrinsicHandler> Intrinsics;
+  std::vector<llvm::Value *> NamedValues;
   std::vector<llvm::Value *> CodeGeneratedValues;
-  std::unordered_map<std::string, llvm::Value *> NamedValues;
-  llvm::Value **LastUsedLValue;
+  SymbolTable::ID LastUsedLValue;
   llvm::Function *F;
 };
 
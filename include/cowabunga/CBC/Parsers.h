@@ -2,9 +2,14 @@
 #define COWABUNGA_CBC_PARSERS_H
 
 #include "cowabunga/CBC/ASTBuilder.h"
-#include "cowabunga/Common/IClonableMixin.h"
+#include "cowabunga/CBC/ASTNodes.h"
+#include "cowabunga/CBC/Tokenizers.h"
 #include "cowabunga/Lexer/Lexer.h"
-#include "cowabunga/Parser/ICFGRule.h"
+#include "cowabunga/Lexer/SymbolTable.h"
+#include "cowabunga/Parser/CFGParser.h"
+#include "cowabunga/Parser/LALRTable.h"
+
+#include <memory>
 
 namespace cb {
 
@@ -17,206 +22,35 @@ enum NonTerminalID {
   NTID_ParamList
 };
 
-class ParamListToParamList final
-    : public IClonableMixin<ICFGRule, ParamListToParamList> {
-public:
-  ParamListToParamList(const Lexer &LexImpl,
-                                         ASTBuilder &ASTBulderObject);
-
-  void parse(TokenIterator ItToken) override;
-
-  void produceError(CFGParserError Error) override;
-
-  Symbol getLHSNonTerminal() const override;
-
-  std::vector<Symbol> getProducts() const override;
-
-private:
-  const Lexer *Lex;
-  ASTBuilder *Builder;
-};
-
-class ParamListToParam final
-    : public IClonableMixin<ICFGRule, ParamListToParam> {
-public:
-  ParamListToParam(const Lexer &LexImpl,
-                                         ASTBuilder &ASTBulderObject);
-
-  void parse(TokenIterator ItToken) override;
-
-  void produceError(CFGParserError Error) override;
-
-  Symbol getLHSNonTerminal() const override;
-
-  std::vector<Symbol> getProducts() const override;
-
-private:
-  const Lexer *Lex;
-  ASTBuilder *Builder;
-};
-
-class TopLevelExpressionToCompoundExpression final
-    : public IClonableMixin<ICFGRule, TopLevelExpressionToCompoundExpression> {
-public:
-  TopLevelExpressionToCompoundExpression(const Lexer &LexImpl,
-                                         ASTBuilder &ASTBulderObject);
-
-  void parse(TokenIterator ItToken) override;
-
-  void produceError(CFGParserError Error) override;
-
-  Symbol getLHSNonTerminal() const override;
-
-  std::vector<Symbol> getProducts() const override;
-
-private:
-  const Lexer *Lex;
-  ASTBuilder *Builder;
-};
-
-class CompoundExpressionToExpressionSequence final
-    : public IClonableMixin<ICFGRule, CompoundExpressionToExpressionSequence> {
-public:
-  CompoundExpressionToExpressionSequence(const Lexer &LexImpl,
-                                         ASTBuilder &ASTBulderObject);
-
-  void parse(TokenIterator ItToken) override;
-
-  void produceError(CFGParserError Error) override;
-
-  Symbol getLHSNonTerminal() const override;
-
-  std::vector<Symbol> getProducts() const override;
-
-private:
-  const Lexer *Lex;
-  ASTBuilder *Builder;
-};
-
-class CompoundExpressionToSingleExpression final
-    : public IClonableMixin<ICFGRule, CompoundExpressionToSingleExpression> {
-public:
-  CompoundExpressionToSingleExpression(const Lexer &LexImpl,
-                                       ASTBuilder &ASTBulderObject);
-
-  void parse(TokenIterator ItToken) override;
-
-  void produceError(CFGParserError Error) override;
-
-  Symbol getLHSNonTerminal() const override;
-
-  std::vector<Symbol> getProducts() const override;
-
-private:
-  const Lexer *Lex;
-  ASTBuilder *Builder;
-};
-
-class ExpressionToAssignment final
-    : public IClonableMixin<ICFGRule, ExpressionToAssignment> {
-public:
-  ExpressionToAssignment(const Lexer &LexImpl, ASTBuilder &ASTBulderObject);
-
-  void parse(TokenIterator ItToken) override;
-
-  void produceError(CFGParserError Error) override;
-
-  Symbol getLHSNonTerminal() const override;
-
-  std::vector<Symbol> getProducts() const override;
-
-private:
-  const Lexer *Lex;
-  ASTBuilder *Builder;
-};
-
-class ExpressionToRValue final
-    : public IClonableMixin<ICFGRule, ExpressionToRValue> {
-public:
-  ExpressionToRValue(const Lexer &LexImpl, ASTBuilder &ASTBulderObject);
-
-  void parse(TokenIterator ItToken) override;
-
-  void produceError(CFGParserError Error) override;
-
-  Symbol getLHSNonTerminal() const override;
-
-  std::vector<Symbol> getProducts() const override;
-
-private:
-  const Lexer *Lex;
-  ASTBuilder *Builder;
-};
-
-class RValueToCall final : public IClonableMixin<ICFGRule, RValueToCall> {
-public:
-  RValueToCall(const Lexer &LexImpl, ASTBuilder &ASTBulderObject);
-
-  void parse(TokenIterator ItToken) override;
-
-  void produceError(CFGParserError Error) override;
-
-  Symbol getLHSNonTerminal() const override;
-
-  std::vector<Symbol> getProducts() const override;
-
-private:
-  const Lexer *Lex;
-  ASTBuilder *Builder;
-};
-
-class RValueToLValue final : public IClonableMixin<ICFGRule, RValueToLValue> {
-public:
-  RValueToLValue(const Lexer &LexImpl, ASTBuilder &ASTBulderObject);
-
-  void parse(TokenIterator ItToken) override;
-
-  void produceError(CFGParserError Error) override;
-
-  Symbol getLHSNonTerminal() const override;
-
-  std::vector<Symbol> getProducts() const override;
-
-private:
-  const Lexer *Lex;
-  ASTBuilder *Builder;
-};
-
-class RValueToIntegralNumber final
-    : public IClonableMixin<ICFGRule, RValueToIntegralNumber> {
-public:
-  RValueToIntegralNumber(const Lexer &LexImpl, ASTBuilder &ASTBulderObject);
-
-  void parse(TokenIterator ItToken) override;
-
-  void produceError(CFGParserError Error) override;
-
-  Symbol getLHSNonTerminal() const override;
-
-  std::vector<Symbol> getProducts() const override;
-
-private:
-  const Lexer *Lex;
-  ASTBuilder *Builder;
-};
-
-class LValueToIdentifier final
-    : public IClonableMixin<ICFGRule, LValueToIdentifier> {
-public:
-  LValueToIdentifier(const Lexer &LexImpl, ASTBuilder &ASTBulderObject);
-
-  void parse(TokenIterator ItToken) override;
-
-  void produceError(CFGParserError Error) override;
-
-  Symbol getLHSNonTerminal() const override;
-
-  std::vector<Symbol> getProducts() const override;
-
-private:
-  const Lexer *Lex;
-  ASTBuilder *Builder;
-};
+/// Returns tokenizer of all keywords and punctuation of scripts.
+KeywordSetTokenizer createScriptKeywords();
+
+/// Returns lexer of scripts: identifiers, integral numbers and the keywords
+/// above. It isn't compiled.
+Lexer createScriptLexer();
+
+/// Returns parser of scripts with all script rules added. cbc-tablegen builds
+/// LALR(1) tables of the same rules, so they should be added only here. Rules
+/// build the AST through ASTBulderObject, which expects rules to be applied
+/// in the streaming order, so the parser is set to
+/// CFGParserActionMode::Streaming and its action mode shouldn't be changed.
+CFGParser createScriptParser(const Lexer &LexImpl,
+                             ASTBuilder &ASTBulderObject);
+
+/// Parses a script and returns its AST, names are interned into Symbols.
+/// Top-level statements are split into chunks which are parsed on
+/// ThreadsNumber threads, each with its own parser and ASTBuilder, and then
+/// merged into one compound expression in source order. The AST, symbol IDs
+/// and diagnostics are the same as of parsing on one thread. Table are
+/// LALR(1) tables of the script grammar, they are built if Table is nullptr.
+/// ThreadsNumber equal to 0 means the number of hardware threads. Small
+/// scripts are parsed on the calling thread only.
+std::unique_ptr<IASTNode> parseScript(const Lexer &LexImpl,
+                                      SymbolTable &Symbols,
+                                      TokenIterator ItBegin,
+                                      TokenIterator ItEnd,
+                                      const LALRTableData *Table = nullptr,
+                                      unsigned ThreadsNumber = 0);
 
 } // namespace cb
 
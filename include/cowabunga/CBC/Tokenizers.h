@@ -4,8 +4,12 @@
 #include "cowabunga/Lexer/ITokenizer.h"
 #include "cowabunga/Lexer/Token.h"
 
+#include <array>
+#include <cstdint>
 #include <string_view>
 #include <unordered_map>
+#include <utility>
+#include <vector>
 
 namespace cb {
 
@@ -21,22 +25,36 @@ enum TokenID {
   TID_IntegralNumber
 };
 
+/// Identifiers are an underscore or a XID_Start character followed by
+/// XID_Continue characters, encoded in UTF-8.
 class IdentifierTokenizer : public ITokenizer {
 public:
   std::pair<std::optional<Token>, size_t> tokenize(std::string_view Word) override;
 
+  size_t matchLength(std::string_view Word) override;
+
+  Token buildToken(std::string_view Lexeme) override;
+
   int getTokenID() const override;
 
   std::string getLexemeString() const override;
+
+  std::vector<TokenPattern> getPatterns() const override;
 };
 
 class IntegralNumberTokenizer : public ITokenizer {
 public:
   std::pair<std::optional<Token>, size_t> tokenize(std::string_view Word) override;
 
+  size_t matchLength(std::string_view Word) override;
+
+  Token buildToken(std::string_view Lexeme) override;
+
   int getTokenID() const override;
 
   std::string getLexemeString() const override;
+
+  std::vector<TokenPattern> getPatterns() const override;
 };
 
 class KeywordTokenizer : public ITokenizer {
@@ -45,15 +63,66 @@ public:
 
   std::pair<std::optional<Token>, size_t> tokenize(std::string_view Word) override;
 
+  size_t matchLength(std::string_view Word) override;
+
+  Token buildToken(std::string_view Lexeme) override;
+
   int getTokenID() const override;
 
   std::string getLexemeString() const override;
 
+  std::vector<TokenPattern> getPatterns() const override;
+
 private:
   TokenID ID;
   std::string KeywordString;
 };
 
+/// KeywordSetTokenizer recognizes a whole table of keywords in one pass over
+/// the input. Like Lexer, it produces token of the matching keyword with the
+/// greatest ID, the longest one among keywords with the same ID. Keywords are
+/// stored in a packed trie: children of every node are contiguous, and the
+/// first character is looked up directly.
+class KeywordSetTokenizer : public ITokenizer {
+public:
+  KeywordSetTokenizer(std::vector<std::pair<TokenID, std::string>> Keywords);
+
+  std::pair<std::optional<Token>, size_t> tokenize(std::string_view Word) override;
+
+  size_t matchLength(std::string_view Word) override;
+
+  Token buildToken(std::string_view Lexeme) override;
+
+  /// Returns ID of the first keyword in the table.
+  int getTokenID() const override;
+
+  /// Returns the first keyword in the table.
+  std::string getLexemeString() const override;
+
+  std::vector<std::pair<int, std::string>> getLexemeStrings() const override;
+
+  std::vector<TokenPattern> getPatterns() const override;
+
+private:
+  struct TrieNode {
+    uint32_t FirstChild;
+    uint32_t ChildrenNumber;
+    int ID;
+    bool Terminal;
+  };
+
+  void buildTrie();
+
+  /// Returns trie node and length of the keyword Word begins with which has
+  /// the greatest ID.
+  std::pair<uint32_t, size_t> findBestKeyword(std::string_view Word) const;
+
+  std::vector<std::pair<TokenID, std::string>> KeywordTable;
+  std::array<uint32_t, 256> RootChildren;
+  std::vector<TrieNode> Nodes;
+  std::vector<char> NodeChars;
+};
+
 } // namespace cb
 
 #endif // COWABUNGA_CBC_TOKENIZERS_H
@@ -0,0 +1,60 @@
+#ifndef COWABUNGA_COMMON_THREADPOOL_H
+#define COWABUNGA_COMMON_THREADPOOL_H
+
+#include <condition_variable>
+#include <cstddef>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace cb {
+
+/// ThreadPool runs batches of jobs on worker threads which are started once
+/// and reused by later batches. Batches of concurrent callers run one after
+/// another.
+class ThreadPool final {
+public:
+  ThreadPool() = default;
+
+  ThreadPool(const ThreadPool &RHS) = delete;
+
+  ThreadPool &operator=(const ThreadPool &RHS) = delete;
+
+  /// Waits for the running batch and stops all workers.
+  ~ThreadPool();
+
+  /// Calls Job(0), ..., Job(JobsNumber - 1) on the calling thread and at
+  /// most ThreadsNumber - 1 workers, and returns once all calls are done.
+  /// Workers are started if the pool has fewer of them.
+  void run(size_t JobsNumber, unsigned ThreadsNumber,
+           const std::function<void(size_t)> &Job);
+
+  /// Returns the pool shared by the whole process.
+  static ThreadPool &getShared();
+
+private:
+  /// Calls jobs of the current batch until all of them are taken. Lock
+  /// holds Mutex.
+  void runJobs(std::unique_lock<std::mutex> &Lock);
+
+  void work();
+
+  std::vector<std::thread> Workers;
+  /// Makes batches of concurrent callers run one after another.
+  std::mutex RunMutex;
+  std::mutex Mutex;
+  std::condition_variable BatchStarted;
+  std::condition_variable JobsFinished;
+  const std::function<void(size_t)> *Job = nullptr;
+  size_t NextJob = 0;
+  size_t JobsNumber = 0;
+  size_t JobsRunning = 0;
+  /// Number of workers which may take jobs of the current batch.
+  size_t FreeSlots = 0;
+  bool Stopping = false;
+};
+
+} // namespace cb
+
+#endif // COWABUNGA_COMMON_THREADPOOL_H
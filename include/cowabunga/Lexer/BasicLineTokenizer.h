@@ -0,0 +1,119 @@
+#ifndef COWABUNGA_LEXER_BASICLINETOKENIZER_H
+#define COWABUNGA_LEXER_BASICLINETOKENIZER_H
+
+#include "cowabunga/Lexer/CharScanners.h"
+#include "cowabunga/Lexer/LexerDiagnostics.h"
+#include "cowabunga/Lexer/SourceBuffer.h"
+#include "cowabunga/Lexer/Token.h"
+
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <iostream>
+#include <optional>
+#include <ostream>
+#include <string_view>
+#include <utility>
+
+namespace cb {
+
+/// BasicLineTokenizer walks over lines of one source and produces its tokens
+/// one at a time, reporting unrecognized lexemes as it goes. TMatcher picks
+/// the token the rest of a line begins with: Match(Line) returns the token,
+/// or nullopt if nothing matches, and its length.
+template <class TMatcher> class BasicLineTokenizer {
+public:
+  BasicLineTokenizer(TMatcher MatcherImpl, const SourceBuffer &SourceRef,
+                     uint32_t SourceFileIndex)
+      : BasicLineTokenizer(std::move(MatcherImpl), SourceRef, SourceFileIndex,
+                           0, SourceRef.getText().length(), std::cerr) {}
+
+  /// Tokenizes only lines in [RangeBegin, RangeEnd) and reports
+  /// unrecognized lexemes to Diagnostics. RangeBegin must be the beginning
+  /// of a line and RangeEnd must be the beginning of a line or the end of
+  /// the source.
+  BasicLineTokenizer(TMatcher MatcherImpl, const SourceBuffer &SourceRef,
+                     uint32_t SourceFileIndex, size_t RangeBegin,
+                     size_t RangeEnd, std::ostream &Diagnostics)
+      : Match(std::move(MatcherImpl)), Source(SourceRef),
+        FileIndex(SourceFileIndex), Errors(Diagnostics), EndOffset(RangeEnd),
+        NextLineOffset(RangeBegin), LineOffset(RangeBegin), Position(0),
+        Error(0) {
+    assert(RangeBegin <= RangeEnd &&
+           RangeEnd <= SourceRef.getText().length() &&
+           "Tokenized range is out of source");
+  }
+
+  /// Returns the next token of the source or nullopt if the source is over.
+  std::optional<Token> next() {
+    while (true) {
+      skipWhitespace();
+      if (Position == FullLine.length()) {
+        if (!startNextLine()) {
+          return std::nullopt;
+        }
+        continue;
+      }
+      auto [BestToken, BestTokenLength] = Match(Line);
+      if (!BestToken) {
+        reportUnrecognizedLexeme(Errors, Source, LineOffset, FullLine,
+                                 Position);
+        Error = 1;
+        skip(scanNonWhitespace(Line));
+        continue;
+      }
+      BestToken->FileIndex = FileIndex;
+      BestToken->Offset = static_cast<uint32_t>(LineOffset + Position);
+      BestToken->Length = static_cast<uint32_t>(BestTokenLength);
+      skip(BestTokenLength);
+      return BestToken;
+    }
+  }
+
+  int getError() const noexcept { return Error; }
+
+  const SourceBuffer &getSource() const noexcept { return Source; }
+
+  operator bool() const noexcept { return Error == 0; }
+
+private:
+  bool startNextLine() {
+    auto Text = Source.getText();
+    if (NextLineOffset >= EndOffset) {
+      return false;
+    }
+    size_t LineEnd = Text.find('\n', NextLineOffset);
+    if (LineEnd == std::string_view::npos || LineEnd > EndOffset) {
+      LineEnd = EndOffset;
+    }
+    LineOffset = NextLineOffset;
+    NextLineOffset = LineEnd + 1;
+    FullLine = Text.substr(LineOffset, LineEnd - LineOffset);
+    Line = FullLine;
+    Position = 0;
+    return true;
+  }
+
+  void skipWhitespace() { skip(scanWhitespace(Line)); }
+
+  void skip(size_t Length) {
+    Line.remove_prefix(Length);
+    Position += Length;
+  }
+
+  TMatcher Match;
+  const SourceBuffer &Source;
+  uint32_t FileIndex;
+  std::ostream &Errors;
+  size_t EndOffset;
+  std::string_view FullLine;
+  std::string_view Line;
+  size_t NextLineOffset;
+  size_t LineOffset;
+  size_t Position;
+  int Error;
+};
+
+} // namespace cb
+
+#endif // COWABUNGA_LEXER_BASICLINETOKENIZER_H
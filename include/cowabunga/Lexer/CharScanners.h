@@ -0,0 +1,41 @@
+#ifndef COWABUNGA_LEXER_CHARSCANNERS_H
+#define COWABUNGA_LEXER_CHARSCANNERS_H
+
+#include <cstddef>
+#include <string_view>
+#include <vector>
+
+namespace cb {
+
+/// Character scanners return the length of the longest prefix of Text whose
+/// characters belong to some ASCII class. They don't depend on locale and
+/// use SSE2 or AVX2 kernels, chosen at runtime, to check 16 or 32 characters
+/// at once.
+
+/// Spaces and tabs.
+size_t scanWhitespace(std::string_view Text);
+
+/// Everything except spaces and tabs.
+size_t scanNonWhitespace(std::string_view Text);
+
+/// Latin letters, digits and underscores.
+size_t scanIdentifierChars(std::string_view Text);
+
+/// Decimal digits.
+size_t scanDigits(std::string_view Text);
+
+/// Bytes below 0x80.
+size_t scanASCII(std::string_view Text);
+
+/// Appends offset following every newline character of Text to LineStarts.
+void findLineStarts(std::string_view Text, std::vector<size_t> &LineStarts);
+
+/// Returns true for Latin letters and underscore.
+bool isIdentifierStart(char Char);
+
+/// Returns name of the kernels used by scanners: "avx2", "sse2" or "scalar".
+const char *getCharScannersKind();
+
+} // namespace cb
+
+#endif // COWABUNGA_LEXER_CHARSCANNERS_H
@@ -1,9 +1,14 @@
 #ifndef COWABUNGA_LEXER_ITOKENIZER_H
 #define COWABUNGA_LEXER_ITOKENIZER_H
 
+#include "cowabunga/Lexer/TokenPattern.h"
+
 #include <optional>
+#include <string>
 #include <string_view>
 #include <type_traits>
+#include <utility>
+#include <vector>
 
 namespace cb {
 
@@ -13,10 +18,32 @@ class ITokenizer {
 public:
   virtual std::pair<std::optional<Token>, size_t> tokenize(std::string_view Word) = 0;
 
+  /// Returns length of the token Word begins with or 0 if there is no such
+  /// token. Lexer probes every tokenizer with matchLength and builds tokens
+  /// of the matches: the token with the greatest ID wins, the longest one
+  /// among tokens with the same ID. By default it is implemented with
+  /// tokenize.
+  virtual size_t matchLength(std::string_view Word);
+
+  /// Returns token of Lexeme, which is a prefix accepted by matchLength. By
+  /// default it is implemented with tokenize.
+  virtual Token buildToken(std::string_view Lexeme);
+
   virtual int getTokenID() const = 0;
 
   virtual std::string getLexemeString() const = 0;
 
+  /// Returns lexeme strings of all tokens this tokenizer produces. By default
+  /// it is the only pair of getTokenID and getLexemeString.
+  virtual std::vector<std::pair<int, std::string>> getLexemeStrings() const;
+
+  /// Returns patterns of tokens this tokenizer recognizes, so that Lexer can
+  /// compile it into a TokenDFA. Empty result means that the tokenizer can't
+  /// be described by patterns. Patterns only have to be exact on ASCII
+  /// input: tokens starting or continuing with non-ASCII characters are
+  /// matched by the tokenizer itself.
+  virtual std::vector<TokenPattern> getPatterns() const;
+
   virtual ~ITokenizer();
 };
 
@@ -0,0 +1,29 @@
+#ifndef COWABUNGA_LEXER_LEXEMETABLE_H
+#define COWABUNGA_LEXER_LEXEMETABLE_H
+
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace cb {
+
+/// LexemeTable maps token IDs to their human-readable lexemes. Token IDs are
+/// small non-negative integers, so lexemes are stored in a vector indexed by
+/// ID. Views returned by get are invalidated by the next set.
+class LexemeTable final {
+public:
+  void set(int TokenID, std::string Lexeme);
+
+  bool contains(int TokenID) const noexcept;
+
+  /// Throws std::out_of_range if TokenID has no lexeme.
+  std::string_view get(int TokenID) const;
+
+private:
+  std::vector<std::string> Lexemes;
+  std::vector<bool> Present;
+};
+
+} // namespace cb
+
+#endif // COWABUNGA_LEXER_LEXEMETABLE_H
@@ -1,10 +1,18 @@
 #ifndef COWABUNGA_LEXER_LEXER_H
 #define COWABUNGA_LEXER_LEXER_H
 
+#include "cowabunga/Lexer/LexemeTable.h"
+#include "cowabunga/Lexer/SourceBuffer.h"
+#include "cowabunga/Lexer/SourceEdit.h"
+#include "cowabunga/Lexer/SourceManager.h"
 #include "cowabunga/Lexer/Token.h"
+#include "cowabunga/Lexer/TokenDFA.h"
+#include "cowabunga/Lexer/TokenStream.h"
 #include "cowabunga/Lexer/TokenizerProxy.h"
 
-#include <unordered_map>
+#include <memory>
+#include <optional>
+#include <string_view>
 #include <vector>
 
 namespace cb {
@@ -24,20 +32,71 @@ public:
   Lexer &operator=(Lexer &&RHS) noexcept = default;
 
   template <class TTokenizer> Lexer &addTokenizer(TTokenizer &&TokenizerImpl) {
-    LexemeStringMapping[TokenizerImpl.getTokenID()] = TokenizerImpl.getLexemeString();
+    for (auto &[ID, LexemeString] : TokenizerImpl.getLexemeStrings()) {
+      Lexemes.set(ID, std::move(LexemeString));
+    }
     Tokenizers.push_back(
         std::make_unique<TokenizerProxy<TTokenizer>>(std::forward<TTokenizer>(TokenizerImpl)));
+    DFA.reset();
     return *this;
   }
 
+  /// Merges patterns of all added tokenizers into a single TokenDFA, which
+  /// is then used by tokenize instead of trying tokenizers one by one.
+  /// Returns false and leaves Lexer unchanged if some tokenizer provides no
+  /// patterns.
+  bool compile();
+
+  bool isCompiled() const noexcept;
+
   std::vector<Token> tokenize(std::istream &Input,
                               const std::string &FileName = "");
 
-  std::string getTokenLexeme(int ID) const;
+  std::vector<Token> tokenize(std::shared_ptr<const SourceBuffer> Source);
+
+  /// Splits Source at line boundaries into chunks, tokenizes them on
+  /// ThreadsNumber threads of the shared ThreadPool and concatenates the
+  /// results in order. Output and diagnostics are the same as of tokenize.
+  /// ThreadsNumber equal to 0 means the number of hardware threads. Small
+  /// sources are tokenized on the calling thread only.
+  std::vector<Token>
+  tokenizeParallel(std::shared_ptr<const SourceBuffer> Source,
+                   unsigned ThreadsNumber = 0);
+
+  /// Maps the file into memory and tokenizes it in place. Returns nullopt if
+  /// the file can't be opened.
+  std::optional<std::vector<Token>> tokenizeFile(const std::string &Path);
+
+  /// Applies Edit to the source with FileIndex and updates Tokens, which are
+  /// all tokens of that source, re-lexing only lines touched by the edit.
+  /// Tokens after the edit are shifted, tokens before it are kept as is. The
+  /// call is still linear in the size of the source, as the text is copied
+  /// into a new buffer and offsets of the following tokens are shifted.
+  TokenRangeChange retokenize(std::vector<Token> &Tokens, uint32_t FileIndex,
+                              const SourceEdit &Edit);
+
+  /// Returns TokenStream which lexes Source on demand and buffers at most
+  /// LookaheadLimit tokens.
+  TokenStream stream(std::shared_ptr<const SourceBuffer> Source,
+                     size_t LookaheadLimit = 16);
+
+  /// Returns lexeme string of token ID, such as "identifier" or ";". The
+  /// view is valid until the next addTokenizer.
+  std::string_view getTokenLexeme(int ID) const;
+
+  /// Returns SourceManager that resolves text and location of every Token
+  /// produced by this Lexer.
+  const SourceManager &getSourceManager() const noexcept;
 
 private:
-  std::unordered_map<int, std::string> LexemeStringMapping;
+  uint32_t addSource(std::shared_ptr<const SourceBuffer> Source);
+
+  std::vector<std::unique_ptr<ITokenizerProxy>> cloneTokenizers() const;
+
+  LexemeTable Lexemes;
   std::vector<std::unique_ptr<ITokenizerProxy>> Tokenizers;
+  std::shared_ptr<const TokenDFA> DFA;
+  SourceManager Sources;
 };
 
 } // namespace cb
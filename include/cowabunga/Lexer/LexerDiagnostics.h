@@ -0,0 +1,31 @@
+#ifndef COWABUNGA_LEXER_LEXERDIAGNOSTICS_H
+#define COWABUNGA_LEXER_LEXERDIAGNOSTICS_H
+
+#include "cowabunga/Lexer/SourceBuffer.h"
+
+#include <cstddef>
+#include <ostream>
+#include <string_view>
+
+namespace cb {
+
+/// Prints location of the lexeme starting at Position of Line and underlines
+/// it up to the next whitespace. Line starts at LineOffset of Source, its
+/// number is looked up only here, so that lexing without errors never builds
+/// the line table.
+void reportUnrecognizedLexeme(std::ostream &Errors, const SourceBuffer &Source,
+                              size_t LineOffset, std::string_view Line,
+                              size_t Position);
+
+/// Checks that the whole Source is valid UTF-8. Otherwise reports location of
+/// the first invalid byte to Errors and returns false.
+bool checkUTF8(std::ostream &Errors, const SourceBuffer &Source);
+
+/// Checks that offsets in Source fit into tokens and that Source is valid
+/// UTF-8. Otherwise reports why Source can't be tokenized to Errors and
+/// returns false.
+bool checkSource(std::ostream &Errors, const SourceBuffer &Source);
+
+} // namespace cb
+
+#endif // COWABUNGA_LEXER_LEXERDIAGNOSTICS_H
@@ -0,0 +1,39 @@
+#ifndef COWABUNGA_LEXER_LINETABLE_H
+#define COWABUNGA_LEXER_LINETABLE_H
+
+#include <cstddef>
+#include <string_view>
+#include <vector>
+
+namespace cb {
+
+/// LineTable keeps offsets of line beginnings of a text and resolves line,
+/// column and line text of any offset in O(log n). Lines are separated by
+/// '\n', which belongs to the line it ends.
+class LineTable final {
+public:
+  explicit LineTable(std::string_view SourceText);
+
+  /// Returns 1-based number of the line containing Offset.
+  size_t getLineNumber(size_t Offset) const;
+
+  /// Returns 1-based column of Offset in its line.
+  size_t getColumnNumber(size_t Offset) const;
+
+  /// Returns offset of the beginning of the line containing Offset.
+  size_t getLineOffset(size_t Offset) const;
+
+  /// Returns text of the line containing Offset without the trailing newline
+  /// character.
+  std::string_view getLine(size_t Offset) const;
+
+  size_t getLinesNumber() const noexcept;
+
+private:
+  std::string_view Text;
+  std::vector<size_t> LineOffsets;
+};
+
+} // namespace cb
+
+#endif // COWABUNGA_LEXER_LINETABLE_H
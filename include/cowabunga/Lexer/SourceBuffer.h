@@ -0,0 +1,69 @@
+#ifndef COWABUNGA_LEXER_SOURCEBUFFER_H
+#define COWABUNGA_LEXER_SOURCEBUFFER_H
+
+#include "cowabunga/Lexer/LineTable.h"
+
+#include <istream>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+
+namespace cb {
+
+/// SourceBuffer owns the whole text of one source. Files are memory-mapped
+/// when possible, so the text is never copied. Tokens refer to lexemes of the
+/// buffer by offsets. Line offsets are only needed to report locations, so
+/// LineTable is built on the first request.
+class SourceBuffer final {
+public:
+  /// Returns nullptr if the file can't be opened.
+  static std::shared_ptr<const SourceBuffer> fromFile(const std::string &Path);
+
+  static std::shared_ptr<const SourceBuffer> fromStream(std::istream &Input,
+                                                        std::string Name);
+
+  static std::shared_ptr<const SourceBuffer> fromString(std::string Text,
+                                                        std::string Name);
+
+  SourceBuffer(const SourceBuffer &RHS) = delete;
+
+  SourceBuffer &operator=(const SourceBuffer &RHS) = delete;
+
+  ~SourceBuffer();
+
+  std::string_view getText() const noexcept;
+
+  /// Returns text of the line beginning at LineOffset without the trailing
+  /// newline character.
+  std::string_view getLine(size_t LineOffset) const;
+
+  /// Builds LineTable of the buffer on the first call. It's safe to call
+  /// concurrently.
+  const LineTable &getLineTable() const;
+
+  /// Returns 1-based number of the line containing Offset.
+  size_t getLineNumber(size_t Offset) const;
+
+  /// Returns offset of the beginning of the line containing Offset.
+  size_t getLineOffset(size_t Offset) const;
+
+  const std::string &getName() const noexcept;
+
+  bool isMapped() const noexcept;
+
+private:
+  SourceBuffer(std::string Name);
+
+  std::string BufferName;
+  std::string Storage;
+  mutable std::once_flag LinesIndexed;
+  mutable std::unique_ptr<LineTable> Lines;
+  const char *Data;
+  size_t Size;
+  bool Mapped;
+};
+
+} // namespace cb
+
+#endif // COWABUNGA_LEXER_SOURCEBUFFER_H
@@ -0,0 +1,28 @@
+#ifndef COWABUNGA_LEXER_SOURCEEDIT_H
+#define COWABUNGA_LEXER_SOURCEEDIT_H
+
+#include <cstddef>
+#include <string>
+
+namespace cb {
+
+/// SourceEdit replaces Length bytes of a source starting at Offset with
+/// Replacement.
+struct SourceEdit {
+  size_t Offset;
+  size_t Length;
+  std::string Replacement;
+};
+
+/// TokenRangeChange describes how Lexer::retokenize changed a token vector:
+/// tokens [Begin, OldEnd) were replaced with tokens [Begin, NewEnd). Tokens
+/// before Begin are unchanged, tokens after it were only shifted.
+struct TokenRangeChange {
+  size_t Begin;
+  size_t OldEnd;
+  size_t NewEnd;
+};
+
+} // namespace cb
+
+#endif // COWABUNGA_LEXER_SOURCEEDIT_H
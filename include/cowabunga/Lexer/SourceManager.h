@@ -0,0 +1,50 @@
+#ifndef COWABUNGA_LEXER_SOURCEMANAGER_H
+#define COWABUNGA_LEXER_SOURCEMANAGER_H
+
+#include "cowabunga/Lexer/SourceBuffer.h"
+#include "cowabunga/Lexer/Token.h"
+
+#include <cstdint>
+#include <memory>
+#include <ostream>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace cb {
+
+/// SourceManager keeps all sources tokenized by a Lexer and resolves file,
+/// line, column and lexeme of a Token on demand.
+class SourceManager final {
+public:
+  uint32_t addBuffer(std::shared_ptr<const SourceBuffer> Buffer);
+
+  const SourceBuffer &getBuffer(uint32_t FileIndex) const;
+
+  /// Replaces the source with FileIndex. Tokens of the previous source become
+  /// invalid.
+  void replaceBuffer(uint32_t FileIndex,
+                     std::shared_ptr<const SourceBuffer> Buffer);
+
+  std::shared_ptr<const SourceBuffer> getBufferPtr(uint32_t FileIndex) const;
+
+  const std::string &getFile(const Token &Tok) const;
+
+  std::string_view getLine(const Token &Tok) const;
+
+  std::string_view getLexeme(const Token &Tok) const;
+
+  size_t getLineNumber(const Token &Tok) const;
+
+  /// Returns 1-based column of the first character of the token.
+  size_t getColumnNumber(const Token &Tok) const;
+
+  void print(std::ostream &Out, const Token &Tok) const;
+
+private:
+  std::vector<std::shared_ptr<const SourceBuffer>> Buffers;
+};
+
+} // namespace cb
+
+#endif // COWABUNGA_LEXER_SOURCEMANAGER_H
@@ -0,0 +1,129 @@
+#ifndef COWABUNGA_LEXER_STATICLEXER_H
+#define COWABUNGA_LEXER_STATICLEXER_H
+
+#include "cowabunga/Lexer/BasicLineTokenizer.h"
+#include "cowabunga/Lexer/ITokenizer.h"
+#include "cowabunga/Lexer/LexemeTable.h"
+#include "cowabunga/Lexer/LexerDiagnostics.h"
+#include "cowabunga/Lexer/SourceBuffer.h"
+#include "cowabunga/Lexer/SourceManager.h"
+#include "cowabunga/Lexer/Token.h"
+
+#include <cassert>
+#include <cstdlib>
+#include <iostream>
+#include <memory>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace cb {
+
+/// StaticLexer is a Lexer with a set of tokenizers fixed at compile time.
+/// Tokenizers are stored by value and called without virtual dispatch, so
+/// the whole matching loop can be inlined. Lines are walked by
+/// BasicLineTokenizer as in Lexer, so for the same tokenizers it produces the
+/// same tokens and diagnostics: on every position the matched token with the
+/// greatest ID wins, the longest one among tokens with the same ID.
+template <class... TTokenizers> class StaticLexer final {
+  static_assert(sizeof...(TTokenizers) > 0,
+                "StaticLexer needs at least one tokenizer");
+  static_assert((std::is_base_of_v<ITokenizer, TTokenizers> && ...),
+                "StaticLexer accepts only ITokenizer implementations");
+
+public:
+  StaticLexer() : StaticLexer(TTokenizers()...) {}
+
+  explicit StaticLexer(TTokenizers... TokenizerImpls)
+      : Tokenizers(std::move(TokenizerImpls)...) {
+    std::apply(
+        [this](auto &...Impls) {
+          (registerLexemeStrings(Impls.getLexemeStrings()), ...);
+        },
+        Tokenizers);
+  }
+
+  std::vector<Token> tokenize(std::istream &Input,
+                              const std::string &FileName = "") {
+    return tokenize(SourceBuffer::fromStream(Input, FileName));
+  }
+
+  std::vector<Token> tokenize(std::shared_ptr<const SourceBuffer> Source) {
+    assert(Source && "Source shouldn't be nullptr");
+    if (!checkSource(std::cerr, *Source)) {
+      exit(1);
+    }
+    uint32_t FileIndex = Sources.addBuffer(Source);
+    auto Match = [this](std::string_view Word) {
+      return findBestToken(Word, std::index_sequence_for<TTokenizers...>());
+    };
+    BasicLineTokenizer<decltype(Match)> Tokenizer(Match, *Source, FileIndex);
+    std::vector<Token> Tokens;
+    while (auto Tok = Tokenizer.next()) {
+      Tokens.push_back(*Tok);
+    }
+    if (!Tokenizer) {
+      std::cerr << "Failed to parse " << Source->getName() << std::endl;
+      exit(1);
+    }
+    return Tokens;
+  }
+
+  /// Maps the file into memory and tokenizes it in place. Returns nullopt if
+  /// the file can't be opened.
+  std::optional<std::vector<Token>> tokenizeFile(const std::string &Path) {
+    auto Source = SourceBuffer::fromFile(Path);
+    if (!Source) {
+      return std::nullopt;
+    }
+    return tokenize(std::move(Source));
+  }
+
+  std::string_view getTokenLexeme(int ID) const { return Lexemes.get(ID); }
+
+  const SourceManager &getSourceManager() const noexcept { return Sources; }
+
+private:
+  void registerLexemeStrings(
+      std::vector<std::pair<int, std::string>> LexemeStrings) {
+    for (auto &[ID, LexemeString] : LexemeStrings) {
+      Lexemes.set(ID, std::move(LexemeString));
+    }
+  }
+
+  /// Qualified calls make matchLength and buildToken non-virtual even if the
+  /// tokenizers aren't final.
+  template <size_t... Indices>
+  std::pair<std::optional<Token>, size_t>
+  findBestToken(std::string_view Word, std::index_sequence<Indices...>) {
+    std::optional<Token> BestToken;
+    size_t BestLength = 0;
+    auto Consider = [&](auto &Tokenizer, size_t Length) {
+      if (!Length) {
+        return;
+      }
+      auto FoundToken = Tokenizer.buildToken(Word.substr(0, Length));
+      if (!BestToken || BestToken->getID() < FoundToken.getID() ||
+          (BestToken->getID() == FoundToken.getID() && BestLength < Length)) {
+        BestToken = FoundToken;
+        BestLength = Length;
+      }
+    };
+    (Consider(std::get<Indices>(Tokenizers),
+              std::get<Indices>(Tokenizers).TTokenizers::matchLength(Word)),
+     ...);
+    return std::make_pair(BestToken, BestLength);
+  }
+
+  std::tuple<TTokenizers...> Tokenizers;
+  LexemeTable Lexemes;
+  SourceManager Sources;
+};
+
+} // namespace cb
+
+#endif // COWABUNGA_LEXER_STATICLEXER_H
@@ -0,0 +1,44 @@
+#ifndef COWABUNGA_LEXER_SYMBOLTABLE_H
+#define COWABUNGA_LEXER_SYMBOLTABLE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+
+namespace cb {
+
+/// SymbolTable interns names and gives each distinct name a dense ID,
+/// starting from 0 in order of interning. Names returned by getName stay
+/// valid as long as the table exists.
+class SymbolTable final {
+public:
+  using ID = uint32_t;
+
+  SymbolTable() = default;
+
+  SymbolTable(const SymbolTable &RHS) = delete;
+
+  SymbolTable &operator=(const SymbolTable &RHS) = delete;
+
+  /// Returns ID of Name, adding Name to the table if it's new.
+  ID intern(std::string_view Name);
+
+  /// Returns ID of Name or nullopt if Name wasn't interned.
+  std::optional<ID> lookup(std::string_view Name) const;
+
+  std::string_view getName(ID SymbolID) const;
+
+  size_t size() const noexcept;
+
+private:
+  std::deque<std::string> Names;
+  std::unordered_map<std::string_view, ID> IDs;
+};
+
+} // namespace cb
+
+#endif // COWABUNGA_LEXER_SYMBOLTABLE_H
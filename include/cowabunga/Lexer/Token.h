@@ -1,39 +1,49 @@
 #ifndef COWABUNGA_LEXER_TOKEN_H
 #define COWABUNGA_LEXER_TOKEN_H
 
-#include "cowabunga/Common/IComparable.h"
-#include "cowabunga/Common/IPrintable.h"
+#include <cstdint>
+#include <type_traits>
 
 namespace cb {
 
 /// Token class represents output of Lexer. Token's ID defines identity and
-/// ordering of tokens.
-class Token final : public IComparable<Token>, public IPrintable {
+/// ordering of tokens. Token is a compact reference to a lexeme inside one of
+/// the sources of SourceManager, which resolves its text, line and column.
+class Token final {
 public:
   Token(int LexemeID);
 
-  int compare(const Token &RHS) const;
-
-  void print(std::ostream &Out) const;
-
-  std::string getFile() const;
+  Token(int LexemeID, uint32_t File, uint32_t LexemeOffset,
+        uint32_t LexemeLength);
 
-  std::string getLine() const;
-
-  std::string getLexeme() const;
+  int compare(const Token &RHS) const;
 
   int getID() const noexcept;
 
-  std::shared_ptr<const std::string> File;
-  std::shared_ptr<const std::string> Line;
-  size_t LineNumber;
-  size_t BeginColumnNumber;
-  size_t EndColumnNumber;
+  uint32_t FileIndex;
+  uint32_t Offset;
+  uint32_t Length;
 
 private:
   int ID;
 };
 
+static_assert(sizeof(Token) == 16, "Token should stay compact");
+static_assert(std::is_trivially_copyable_v<Token>,
+              "Token should be trivially copyable");
+
+inline bool operator==(const Token &LHS, const Token &RHS) {
+  return LHS.compare(RHS) == 0;
+}
+
+inline bool operator!=(const Token &LHS, const Token &RHS) {
+  return LHS.compare(RHS) != 0;
+}
+
+inline bool operator<(const Token &LHS, const Token &RHS) {
+  return LHS.compare(RHS) < 0;
+}
+
 } // namespace cb
 
 #endif // COWABUNGA_LEXER_TOKEN_H
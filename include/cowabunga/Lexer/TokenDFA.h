@@ -0,0 +1,53 @@
+#ifndef COWABUNGA_LEXER_TOKENDFA_H
+#define COWABUNGA_LEXER_TOKENDFA_H
+
+#include "cowabunga/Lexer/TokenPattern.h"
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+namespace cb {
+
+/// TokenDFA is a minimized table-driven automaton built from the patterns of
+/// all tokenizers of a Lexer. It picks a token the same way Lexer does: the
+/// highest priority token matching at the position wins, and it is as long as
+/// the longest prefix this token accepts.
+class TokenDFA final {
+public:
+  explicit TokenDFA(const std::vector<TokenPattern> &Patterns);
+
+  /// Returns ID and length of the best token at the beginning of Word. Length
+  /// is 0 if no token matches.
+  std::pair<int, size_t> match(std::string_view Word) const;
+
+  size_t getStatesNumber() const noexcept;
+
+private:
+  struct AcceptInfo {
+    bool Accepting;
+    int TokenID;
+    int Priority;
+  };
+
+  void buildCharClasses(const std::vector<TokenPattern> &Patterns);
+
+  void buildStates(const std::vector<TokenPattern> &Patterns);
+
+  void minimize();
+
+  static constexpr uint32_t DeadState = 0;
+
+  std::array<uint8_t, 256> CharClasses;
+  size_t CharClassesNumber;
+  uint32_t StartState;
+  std::vector<uint32_t> Transitions;
+  std::vector<AcceptInfo> Accepts;
+};
+
+} // namespace cb
+
+#endif // COWABUNGA_LEXER_TOKENDFA_H
@@ -0,0 +1,66 @@
+#ifndef COWABUNGA_LEXER_TOKENPATTERN_H
+#define COWABUNGA_LEXER_TOKENPATTERN_H
+
+#include <bitset>
+#include <string_view>
+#include <vector>
+
+namespace cb {
+
+/// CharSet is a set of bytes that a single pattern element accepts.
+class CharSet final {
+public:
+  CharSet() = default;
+
+  static CharSet range(unsigned char First, unsigned char Last);
+
+  static CharSet of(std::string_view Chars);
+
+  CharSet &add(const CharSet &RHS);
+
+  bool contains(unsigned char Char) const;
+
+  bool empty() const;
+
+private:
+  std::bitset<256> Chars;
+};
+
+/// TokenPattern describes a token as a sequence of character sets, each of
+/// which is matched either exactly once or any number of times. It is the
+/// form in which tokenizers can be merged into a single TokenDFA.
+class TokenPattern final {
+public:
+  struct Element {
+    CharSet Chars;
+    bool Repeated;
+  };
+
+  explicit TokenPattern(int TokenID);
+
+  TokenPattern(int TokenID, int TokenPriority);
+
+  static TokenPattern literal(int TokenID, std::string_view Literal);
+
+  TokenPattern &one(CharSet Chars);
+
+  TokenPattern &many(CharSet Chars);
+
+  int getTokenID() const noexcept;
+
+  /// Among tokens that match at the same position the one with the highest
+  /// priority wins. By default priority is the token ID, which is the order
+  /// Lexer uses to pick between tokenizers.
+  int getPriority() const noexcept;
+
+  const std::vector<Element> &getElements() const noexcept;
+
+private:
+  std::vector<Element> Elements;
+  int ID;
+  int Priority;
+};
+
+} // namespace cb
+
+#endif // COWABUNGA_LEXER_TOKENPATTERN_H
@@ -0,0 +1,95 @@
+#ifndef COWABUNGA_LEXER_TOKENSTREAM_H
+#define COWABUNGA_LEXER_TOKENSTREAM_H
+
+#include "cowabunga/Lexer/Token.h"
+
+#include <cstddef>
+#include <deque>
+#include <iterator>
+#include <memory>
+#include <optional>
+
+namespace cb {
+
+class LineTokenizer;
+
+/// TokenStream lexes its source lazily: tokens are produced only when they
+/// are requested, and at most LookaheadLimit of them are buffered at once.
+/// TokenStream refers to the Lexer which created it, so the Lexer has to
+/// outlive the stream and stay unchanged while the stream is used.
+class TokenStream final {
+public:
+  class Iterator final {
+  public:
+    using iterator_category = std::input_iterator_tag;
+    using value_type = Token;
+    using difference_type = std::ptrdiff_t;
+    using pointer = const Token *;
+    using reference = const Token &;
+
+    Iterator() : Stream(nullptr) {}
+
+    explicit Iterator(TokenStream &StreamRef) : Stream(&StreamRef) {}
+
+    reference operator*() const { return *Stream->peek(); }
+
+    pointer operator->() const { return Stream->peek(); }
+
+    Iterator &operator++() {
+      Stream->next();
+      return *this;
+    }
+
+    void operator++(int) { Stream->next(); }
+
+    bool operator==(const Iterator &RHS) const { return atEnd() == RHS.atEnd(); }
+
+    bool operator!=(const Iterator &RHS) const { return !(*this == RHS); }
+
+  private:
+    bool atEnd() const { return !Stream || !Stream->peek(); }
+
+    TokenStream *Stream;
+  };
+
+  TokenStream(TokenStream &&RHS) noexcept;
+
+  TokenStream &operator=(TokenStream &&RHS) noexcept;
+
+  ~TokenStream();
+
+  /// Returns token Ahead positions after the current one without consuming
+  /// it, or nullptr if the source ends earlier. Ahead must be less than
+  /// LookaheadLimit.
+  const Token *peek(size_t Ahead = 0);
+
+  /// Consumes and returns the current token, or returns nullopt at the end
+  /// of the source.
+  std::optional<Token> next();
+
+  size_t getLookaheadLimit() const noexcept;
+
+  Iterator begin();
+
+  Iterator end();
+
+  /// Returns false if some lexemes produced so far weren't recognized.
+  operator bool() const noexcept;
+
+private:
+  friend class Lexer;
+
+  TokenStream(std::unique_ptr<LineTokenizer> TokenizerImpl,
+              size_t MaxLookahead);
+
+  bool fill(size_t TokensNumber);
+
+  std::unique_ptr<LineTokenizer> Tokenizer;
+  std::deque<Token> Lookahead;
+  size_t LookaheadLimit;
+  bool Exhausted;
+};
+
+} // namespace cb
+
+#endif // COWABUNGA_LEXER_TOKENSTREAM_H
@@ -29,6 +29,14 @@ public:
     return TokenizerImpl.tokenize(Word);
   }
 
+  size_t matchLength(std::string_view Word) override {
+    return TokenizerImpl.matchLength(Word);
+  }
+
+  Token buildToken(std::string_view Lexeme) override {
+    return TokenizerImpl.buildToken(Lexeme);
+  }
+
   int getTokenID() const override {
     return TokenizerImpl.getTokenID();
   }
@@ -37,6 +45,14 @@ public:
     return TokenizerImpl.getLexemeString();
   }
 
+  std::vector<std::pair<int, std::string>> getLexemeStrings() const override {
+    return TokenizerImpl.getLexemeStrings();
+  }
+
+  std::vector<TokenPattern> getPatterns() const override {
+    return TokenizerImpl.getPatterns();
+  }
+
 private:
   Tokenizer TokenizerImpl;
 };
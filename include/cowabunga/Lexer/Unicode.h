@@ -0,0 +1,28 @@
+#ifndef COWABUNGA_LEXER_UNICODE_H
+#define COWABUNGA_LEXER_UNICODE_H
+
+#include <cstddef>
+#include <string_view>
+#include <utility>
+
+namespace cb {
+
+/// Returns length of the longest prefix of Text which is valid UTF-8. ASCII
+/// runs are skipped with vectorized scanASCII, so validation of ASCII text
+/// costs about as much as a memchr over it.
+size_t scanValidUTF8(std::string_view Text);
+
+/// Decodes the code point Text begins with. Returns the code point and length
+/// of its encoding, or zero length if Text doesn't begin with a valid UTF-8
+/// sequence.
+std::pair<char32_t, size_t> decodeUTF8(std::string_view Text);
+
+/// Unicode XID_Start property.
+bool isXIDStart(char32_t CodePoint);
+
+/// Unicode XID_Continue property.
+bool isXIDContinue(char32_t CodePoint);
+
+} // namespace cb
+
+#endif // COWABUNGA_LEXER_UNICODE_H
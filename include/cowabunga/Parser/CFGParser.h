@@ -2,17 +2,59 @@
 #define COWABUNGA_PARSER_CFG_PARSER_H
 
 #include "cowabunga/Lexer/Lexer.h"
+#include "cowabunga/Parser/GrammarIndex.h"
 #include "cowabunga/Parser/ICFGRule.h"
+#include "cowabunga/Parser/LALRTable.h"
+#include "cowabunga/Parser/LL1Table.h"
 #include "cowabunga/Parser/Symbol.h"
 
 #include <algorithm>
+#include <cstddef>
 #include <limits>
 #include <memory>
+#include <ostream>
 #include <stack>
+#include <string>
 #include <vector>
 
 namespace cb {
 
+enum class CFGParserAlgorithm {
+  /// Depth-first search over derivations, exponential in the worst case.
+  Backtracking,
+  /// Earley parsing, polynomial for every grammar.
+  Earley,
+  /// Shift-reduce parsing with LALR(1) tables, linear for LALR(1) grammars.
+  /// Grammars with conflicts are parsed by backtracking.
+  LALR
+};
+
+/// Tells when and in which order rules of the derivation are applied, that
+/// is ICFGRule::parse is called. Every rule is applied after all rules of
+/// its products.
+enum class CFGParserActionMode {
+  /// Rules are applied once the whole input has been parsed. Products of
+  /// every rule are applied from the last one to the first one.
+  Replay,
+  /// Rules are applied as soon as their derivations are committed, in order
+  /// LR parsers reduce them: products of every rule are applied from the
+  /// first one to the last one. LL(1) and LALR parsing commit a rule once
+  /// all of its products have been read, other algorithms commit the whole
+  /// derivation at the end of input. If the input has errors, rules
+  /// committed before the error has been found are applied.
+  Streaming
+};
+
+/// Counters of the memo table of the latest parse.
+struct CFGParserMemoStats {
+  /// Number of expansions which reused remembered derivations.
+  size_t Hits = 0;
+  /// Number of expansions which had to derive the nonterminal.
+  size_t Misses = 0;
+  /// Number of remembered positions and derivation ends.
+  size_t Records = 0;
+};
+
 class CFGParser final {
 public:
   CFGParser(Symbol StartNonTerminal);
@@ -35,14 +77,88 @@ public:
                                               RHS->getLHSNonTerminal();
                                      });
   Rules.insert(ItInsertTo, std::move(NewRule));
+  Table.reset();
+  LRTable.reset();
+  LRData = nullptr;
+  Grammar.reset();
   return *this;
   }
 
+  /// Builds LL(1) predict table of the added rules. If the grammar is LL(1),
+  /// parse applies the only predicted rule to every nonterminal and runs in
+  /// linear time. Otherwise conflicts are available from getConflicts, and
+  /// parse keeps backtracking, skipping the rules which can't start with the
+  /// next token.
+  ///
+  /// With LALR algorithm LALR(1) tables are built as well, unless they have
+  /// been set by setLALRTable. Returns false if parse doesn't run in linear
+  /// time.
+  bool compile();
+
+  bool isCompiled() const noexcept;
+
+  /// Returns conflicts found by the last compile.
+  const std::vector<LL1Conflict> &getConflicts() const;
+
+  /// Returns conflicts of LALR(1) tables built by the last compile.
+  const std::vector<LALRConflict> &getLALRConflicts() const;
+
+  /// Makes LALR algorithm use precomputed tables instead of building them.
+  /// Data should outlive the parser. Returns false and keeps the tables
+  /// unset if Data has been built from other rules.
+  bool setLALRTable(const LALRTableData &Data);
+
+  /// Builds LALR(1) tables of the added rules and writes them as a C++
+  /// header, see LALRTable::writeHeader. Returns false and writes nothing if
+  /// the grammar isn't LALR(1).
+  bool writeLALRTable(std::ostream &OS, const std::string &Name);
+
+  /// Makes backtracking parse remember where derivations of every
+  /// nonterminal at every token position end, so that they aren't derived
+  /// again on other branches. Limit is the maximum number of records in the
+  /// memo table plus parser stack cells kept alive for them. Once it's
+  /// reached, the memo is dropped and parsing goes on without it. 0 disables
+  /// memoization.
+  void setMemoLimit(size_t Limit) noexcept;
+
+  const CFGParserMemoStats &getMemoStats() const noexcept;
+
+  /// Chooses how grammars which aren't LL(1) are parsed. Backtracking is
+  /// used by default.
+  void setAlgorithm(CFGParserAlgorithm NewAlgorithm) noexcept;
+
+  /// Chooses when rules are applied. Rules are replayed after parsing by
+  /// default.
+  void setActionMode(CFGParserActionMode NewMode) noexcept;
+
   void parse(TokenIterator ItBegin, TokenIterator ItEnd);
 
+  /// Parses tokens pulled from Tokens. LL(1) and LALR(1) parsing pulls them
+  /// one token ahead and keeps copies of the tokens rules begin at only, so
+  /// rules may just dereference the iterator they get, unless they derive
+  /// nothing at the end of input. Backtracking and Earley parsing may return
+  /// to any token read so far, so they read all tokens first.
+  void parse(TokenStream &Tokens);
+
+  /// Returns index of the added rules. It's built on the first call and is
+  /// valid until a rule is added.
+  const GrammarIndex &getGrammarIndex();
+
 private:
+  /// Builds LALR(1) tables of the added rules if there are none.
+  const LALRTableData &getLALRTable();
+
   std::vector<std::unique_ptr<ICFGRule>> Rules;
   Symbol StartSymbol;
+  std::unique_ptr<GrammarIndex> Grammar;
+  std::unique_ptr<LL1Table> Table;
+  std::unique_ptr<LALRTable> LRTable;
+  /// Tables used by LALR algorithm, either of LRTable or precomputed ones.
+  const LALRTableData *LRData = nullptr;
+  size_t MemoLimit = 0;
+  CFGParserMemoStats MemoStats;
+  CFGParserAlgorithm Algorithm = CFGParserAlgorithm::Backtracking;
+  CFGParserActionMode ActionMode = CFGParserActionMode::Replay;
 };
 
 } // namespace cb
@@ -0,0 +1,123 @@
+#ifndef COWABUNGA_PARSER_EARLEYPARSER_H
+#define COWABUNGA_PARSER_EARLEYPARSER_H
+
+#include "cowabunga/Lexer/Lexer.h"
+#include "cowabunga/Parser/GrammarIndex.h"
+#include "cowabunga/Parser/ICFGRule.h"
+#include "cowabunga/Parser/Symbol.h"
+
+#include <cstdint>
+#include <limits>
+#include <unordered_map>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+
+namespace cb {
+
+/// EarleyParser parses input of any context-free grammar in O(n^3) time,
+/// O(n^2) if the grammar is unambiguous. Right recursion is completed through
+/// Leo's transitive items, so input of LR(k) grammars is parsed in O(n).
+///
+/// Every item remembers the first way it has been derived by. If the input
+/// has several derivations, the one built from these links is returned: it
+/// depends only on the grammar and the input.
+class EarleyParser final {
+public:
+  explicit EarleyParser(const GrammarIndex &Grammar);
+
+  /// Returns rules of the derivation of the input in preorder, each with the
+  /// first token it derives. If there is no derivation, produces error and
+  /// returns no rules.
+  std::vector<std::pair<ICFGRule *, TokenIterator>>
+  parse(TokenIterator ItBegin, TokenIterator ItEnd);
+
+private:
+  static constexpr uint32_t None = std::numeric_limits<uint32_t>::max();
+
+  /// Tells how the symbol before the dot of an item has been derived.
+  enum LinkKind : uint8_t {
+    LK_None,
+    LK_Terminal,
+    LK_Empty,
+    LK_Completed,
+    LK_Leo
+  };
+
+  struct Item {
+    uint32_t Rule;
+    uint32_t Dot;
+    uint32_t Origin;
+    /// The same item with the dot one symbol to the left.
+    uint32_t Previous;
+    /// Completed item of the symbol, or its ID if it derives empty string.
+    uint32_t Child;
+    /// Leo record of the symbol, or its position if it derives empty string.
+    uint32_t Aux;
+    LinkKind Kind;
+  };
+
+  /// Leo's transitive item: Awaiting is the only item of its set which waits
+  /// for a nonterminal, and the nonterminal is the last symbol of its rule.
+  struct LeoRecord {
+    uint32_t Awaiting;
+    uint32_t Next;
+    /// The topmost awaiting item of the chain of records.
+    uint32_t Top;
+  };
+
+  /// Builds set Position from items scanned by the previous one.
+  void buildSet(uint32_t Position);
+
+  void addItem(const Item &NewItem);
+
+  void predict(Symbol NonTerminal, uint32_t Position);
+
+  void complete(uint32_t Completed);
+
+  /// Returns Leo record of NonTerminal in set Position, or None if the set
+  /// has no deterministic reduction path for it.
+  uint32_t getLeoRecord(uint32_t Position, int NonTerminalID);
+
+  using WaitingIterator = std::vector<std::pair<int, uint32_t>>::const_iterator;
+
+  std::pair<WaitingIterator, WaitingIterator>
+  getWaitingItems(uint32_t Position, int NonTerminalID) const;
+
+  void indexWaitingItems(uint32_t Position);
+
+  /// Returns completed item of the start symbol which spans the whole input.
+  uint32_t findAcceptingItem() const;
+
+  std::vector<std::pair<ICFGRule *, TokenIterator>>
+  getDerivation(uint32_t Accepting);
+
+  void produceError(uint32_t Position);
+
+  uint64_t getItemKey(const Item &It) const noexcept;
+
+  const GrammarIndex &Grammar;
+  /// Rule which derives the empty string for every nullable nonterminal.
+  /// Rules are chosen so that their derivations are finite.
+  std::vector<uint32_t> EmptyRules;
+  TokenIterator ItInputBegin;
+  uint32_t InputLength;
+  /// The last set where every nonterminal has been predicted.
+  std::vector<uint32_t> PredictedAt;
+  std::vector<Item> Items;
+  std::vector<uint32_t> SetBegins;
+  std::vector<Item> Scanned;
+  /// Keys (dotted rule, origin) of items of the current set.
+  std::unordered_set<uint64_t> SetItems;
+  /// Items of every set waiting for a nonterminal, sorted by nonterminals.
+  std::vector<std::pair<int, uint32_t>> Waiting;
+  std::vector<uint32_t> WaitingBegins;
+  std::unordered_map<uint64_t, uint32_t> LeoRecordsIndex;
+  std::vector<LeoRecord> LeoRecords;
+  /// Keys and awaiting items of records which are being built.
+  std::vector<std::pair<uint64_t, uint32_t>> LeoPath;
+};
+
+} // namespace cb
+
+#endif // COWABUNGA_PARSER_EARLEYPARSER_H
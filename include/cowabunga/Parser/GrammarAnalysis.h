@@ -0,0 +1,120 @@
+#ifndef COWABUNGA_PARSER_GRAMMARANALYSIS_H
+#define COWABUNGA_PARSER_GRAMMARANALYSIS_H
+
+#include "cowabunga/Parser/CFGParser.h"
+#include "cowabunga/Parser/GrammarIndex.h"
+#include "cowabunga/Parser/LALRTable.h"
+#include "cowabunga/Parser/LL1Table.h"
+#include "cowabunga/Parser/Symbol.h"
+
+#include <cstddef>
+#include <vector>
+
+namespace cb {
+
+/// Worst-case time of parsing n tokens, from the best to the worst.
+enum class GrammarComplexity {
+  Linear,
+  Cubic,
+  Exponential,
+  /// Parsing may never finish, as backtracking expands left recursion.
+  NonTerminating
+};
+
+enum class GrammarAmbiguity {
+  /// The grammar is LL(1) or LALR(1).
+  Unambiguous,
+  /// Some input has several derivations: a nonterminal derives itself, or
+  /// a nonterminal has two identical rules or two rules deriving the empty
+  /// string.
+  Ambiguous,
+  /// Ambiguity is undecidable, none of the checks above tells.
+  Unknown
+};
+
+/// GrammarAnalysis finds properties of a grammar which make CFGParser slow or
+/// make it loop: left recursion, ambiguity, LL(1) and LALR(1) conflicts and
+/// useless nonterminals. Only nonterminals which have rules or appear in
+/// products are reported, each once, in order of their IDs.
+class GrammarAnalysis final {
+public:
+  explicit GrammarAnalysis(const GrammarIndex &Grammar);
+
+  /// Nonterminals which derive a sentential form starting with themselves,
+  /// possibly after nullable nonterminals.
+  const std::vector<Symbol> &getLeftRecursive() const noexcept {
+    return LeftRecursive;
+  }
+
+  /// Nonterminals which aren't derived from the start symbol.
+  const std::vector<Symbol> &getUnreachable() const noexcept {
+    return Unreachable;
+  }
+
+  /// Nonterminals which derive no string of terminals.
+  const std::vector<Symbol> &getNonProductive() const noexcept {
+    return NonProductive;
+  }
+
+  /// LL(1) conflicts where the lookahead starts several of the rules.
+  const std::vector<LL1Conflict> &getFirstFirstConflicts() const noexcept {
+    return FirstFirstConflicts;
+  }
+
+  /// LL(1) conflicts where the lookahead starts at most one of the rules and
+  /// follows the nonterminal after the others derive the empty string.
+  const std::vector<LL1Conflict> &getFirstFollowConflicts() const noexcept {
+    return FirstFollowConflicts;
+  }
+
+  const std::vector<LALRConflict> &getLALRConflicts() const noexcept {
+    return LALRConflicts;
+  }
+
+  GrammarAmbiguity getAmbiguity() const noexcept { return Ambiguity; }
+
+  bool isLL1() const noexcept {
+    return FirstFirstConflicts.empty() && FirstFollowConflicts.empty();
+  }
+
+  bool isLALR1() const noexcept { return LALRConflicts.empty(); }
+
+  /// Returns worst-case time of CFGParser::parse with Algorithm. Compiled
+  /// tells whether CFGParser::compile is called before parsing.
+  GrammarComplexity getComplexity(CFGParserAlgorithm Algorithm,
+                                  bool Compiled = true) const noexcept;
+
+private:
+  void findUselessNonTerminals(const GrammarIndex &Grammar);
+
+  void findLeftRecursion(const GrammarIndex &Grammar, const LL1Table &First);
+
+  void classifyConflicts(const GrammarIndex &Grammar, const LL1Table &First);
+
+  void findAmbiguity(const GrammarIndex &Grammar, const LL1Table &First);
+
+  /// Returns true if Products[Begin:End] are nullable nonterminals.
+  static bool isNullable(const LL1Table &First, ProductsRange Products,
+                         size_t Begin, size_t End);
+
+  /// Returns for every nonterminal whether it lies on a cycle of Edges.
+  static std::vector<bool>
+  findCycles(const std::vector<std::vector<int>> &Edges);
+
+  std::vector<bool> Used;
+  std::vector<bool> Productive;
+  std::vector<bool> Reachable;
+  std::vector<Symbol> LeftRecursive;
+  std::vector<Symbol> Unreachable;
+  std::vector<Symbol> NonProductive;
+  std::vector<LL1Conflict> FirstFirstConflicts;
+  std::vector<LL1Conflict> FirstFollowConflicts;
+  std::vector<LALRConflict> LALRConflicts;
+  GrammarAmbiguity Ambiguity = GrammarAmbiguity::Unknown;
+  /// True if backtracking may reach a left-recursive nonterminal.
+  bool LoopsOnLeftRecursion = false;
+};
+
+} // namespace cb
+
+#endif // COWABUNGA_PARSER_GRAMMARANALYSIS_H
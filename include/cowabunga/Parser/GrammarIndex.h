@@ -0,0 +1,113 @@
+#ifndef COWABUNGA_PARSER_GRAMMARINDEX_H
+#define COWABUNGA_PARSER_GRAMMARINDEX_H
+
+#include "cowabunga/Parser/ICFGRule.h"
+#include "cowabunga/Parser/Symbol.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <memory>
+#include <utility>
+#include <vector>
+
+namespace cb {
+
+/// Products of a rule stored in GrammarIndex.
+class ProductsRange final {
+public:
+  using iterator = const Symbol *;
+  using reverse_iterator = std::reverse_iterator<const Symbol *>;
+
+  ProductsRange(const Symbol *ItBegin, const Symbol *ItEnd) noexcept
+      : Begin(ItBegin), End(ItEnd) {}
+
+  iterator begin() const noexcept { return Begin; }
+
+  iterator end() const noexcept { return End; }
+
+  reverse_iterator rbegin() const noexcept { return reverse_iterator(End); }
+
+  reverse_iterator rend() const noexcept { return reverse_iterator(Begin); }
+
+  size_t size() const noexcept { return End - Begin; }
+
+  bool empty() const noexcept { return Begin == End; }
+
+  const Symbol &operator[](size_t Index) const noexcept {
+    return Begin[Index];
+  }
+
+  const Symbol &front() const noexcept { return *Begin; }
+
+private:
+  const Symbol *Begin;
+  const Symbol *End;
+};
+
+/// GrammarIndex freezes rules of a grammar into flat tables, so that parsers
+/// neither call ICFGRule nor allocate when they expand nonterminals. Rules of
+/// a nonterminal are found by its ID through a dense offset array, and
+/// products of all rules are stored in one array. Rules are referred to by
+/// their indices in the vector the index is built from.
+class GrammarIndex final {
+public:
+  /// Rules should be sorted by their LHS nonterminals, as CFGParser keeps
+  /// them.
+  GrammarIndex(Symbol StartSymbol,
+               const std::vector<std::unique_ptr<ICFGRule>> &Rules);
+
+  Symbol getStartSymbol() const noexcept { return Start; }
+
+  size_t getRulesNumber() const noexcept { return RulePointers.size(); }
+
+  /// Returns the greatest nonterminal ID plus one.
+  size_t getNonTerminalsNumber() const noexcept {
+    return RuleOffsets.size() - 1;
+  }
+
+  /// Returns the greatest terminal ID plus one.
+  size_t getTerminalsNumber() const noexcept { return TerminalsNumber; }
+
+  /// Returns indices of all rules of NonTerminalID, in order they were added.
+  std::pair<size_t, size_t> getRules(int NonTerminalID) const noexcept {
+    if (NonTerminalID < 0 ||
+        static_cast<size_t>(NonTerminalID) >= getNonTerminalsNumber()) {
+      return std::make_pair(0, 0);
+    }
+    return std::make_pair(RuleOffsets[NonTerminalID],
+                          RuleOffsets[NonTerminalID + 1]);
+  }
+
+  ProductsRange getProducts(size_t Rule) const noexcept {
+    return ProductsRange(Products.data() + ProductOffsets[Rule],
+                         Products.data() + ProductOffsets[Rule + 1]);
+  }
+
+  /// Returns index of the first product of Rule in the array of products of
+  /// all rules.
+  size_t getProductsOffset(size_t Rule) const noexcept {
+    return ProductOffsets[Rule];
+  }
+
+  int getNonTerminalID(size_t Rule) const noexcept {
+    return RuleNonTerminals[Rule];
+  }
+
+  ICFGRule *getRule(size_t Rule) const noexcept { return RulePointers[Rule]; }
+
+private:
+  Symbol Start;
+  std::vector<ICFGRule *> RulePointers;
+  std::vector<int> RuleNonTerminals;
+  /// Rules of nonterminal I are [RuleOffsets[I], RuleOffsets[I + 1]).
+  std::vector<uint32_t> RuleOffsets;
+  /// Products of rule I are [ProductOffsets[I], ProductOffsets[I + 1]).
+  std::vector<uint32_t> ProductOffsets;
+  std::vector<Symbol> Products;
+  size_t TerminalsNumber;
+};
+
+} // namespace cb
+
+#endif // COWABUNGA_PARSER_GRAMMARINDEX_H
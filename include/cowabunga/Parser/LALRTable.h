@@ -0,0 +1,165 @@
+#ifndef COWABUNGA_PARSER_LALRTABLE_H
+#define COWABUNGA_PARSER_LALRTABLE_H
+
+#include "cowabunga/Parser/GrammarIndex.h"
+#include "cowabunga/Parser/ICFGRule.h"
+#include "cowabunga/Parser/LL1Table.h"
+#include "cowabunga/Parser/Symbol.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <ostream>
+#include <string>
+#include <vector>
+
+namespace cb {
+
+/// Plain view of LALR(1) tables. It refers to arrays either owned by
+/// LALRTable or generated by LALRTable::writeHeader as constexpr arrays.
+///
+/// Column 0 of Actions is the end of input, column I + 1 is terminal I. An
+/// action keeps its kind in the lowest 2 bits and the target state or rule
+/// in the rest. Gotos are 0 where there are none, as no state goes to the
+/// initial one. Products of rule I are
+/// Products[ProductOffsets[I]:ProductOffsets[I + 1]], terminal IDs are kept
+/// as they are and nonterminal ID N is kept as -N - 1.
+struct LALRTableData final {
+  int32_t StartNonTerminal;
+  uint32_t StatesNumber;
+  uint32_t ColumnsNumber;
+  uint32_t NonTerminalsNumber;
+  uint32_t RulesNumber;
+  /// Number of conflicts resolved while the tables were built.
+  uint32_t ConflictsNumber;
+  const uint32_t *Actions;
+  const uint32_t *Gotos;
+  /// Rule which reports errors found in every state.
+  const uint32_t *StateRules;
+  const int32_t *RuleNonTerminals;
+  const uint32_t *ProductOffsets;
+  const int32_t *Products;
+};
+
+/// Several actions are possible in State when the next token is Lookahead.
+/// Rules are the rules which may be reduced; Shift is true if the token may
+/// be shifted as well.
+struct LALRConflict final {
+  uint32_t State;
+  int Lookahead;
+  bool Shift;
+  std::vector<ICFGRule *> Rules;
+};
+
+/// LALRTable is an action/goto table of a shift-reduce parser built from the
+/// LR(0) automaton of a grammar and LALR(1) lookaheads of its items.
+/// Conflicts are resolved in favor of shifts and of rules added first, the
+/// grammar is LALR(1) if there are none.
+class LALRTable final {
+public:
+  enum ActionKind : uint32_t { AK_Error, AK_Shift, AK_Reduce, AK_Accept };
+
+  /// Lookahead at the end of input.
+  static constexpr int EndOfInput = -1;
+
+  /// Grammar should outlive the table.
+  explicit LALRTable(const GrammarIndex &Grammar);
+
+  LALRTable(const LALRTable &) = delete;
+
+  LALRTable &operator=(const LALRTable &) = delete;
+
+  static ActionKind getActionKind(uint32_t Action) noexcept {
+    return static_cast<ActionKind>(Action & 3);
+  }
+
+  /// Returns the target state of a shift or the rule of a reduction.
+  static uint32_t getActionValue(uint32_t Action) noexcept {
+    return Action >> 2;
+  }
+
+  /// Returns true if Data has been built from rules of Grammar.
+  static bool matches(const LALRTableData &Data, const GrammarIndex &Grammar);
+
+  /// Data refers to arrays of the table.
+  const LALRTableData &getData() const noexcept { return Data; }
+
+  bool isLALR1() const noexcept { return Conflicts.empty(); }
+
+  const std::vector<LALRConflict> &getConflicts() const noexcept;
+
+  /// Writes a C++ header which defines Name as constexpr LALRTableData of
+  /// the table.
+  void writeHeader(std::ostream &OS, const std::string &Name) const;
+
+private:
+  static constexpr uint32_t None = std::numeric_limits<uint32_t>::max();
+
+  /// Dotted rule. The augmented rule Start' -> Start is numbered as the
+  /// last rule.
+  struct Item {
+    uint32_t Rule;
+    uint32_t Dot;
+
+    bool operator<(const Item &RHS) const noexcept {
+      return Rule < RHS.Rule || (Rule == RHS.Rule && Dot < RHS.Dot);
+    }
+
+    bool operator==(const Item &RHS) const noexcept {
+      return Rule == RHS.Rule && Dot == RHS.Dot;
+    }
+  };
+
+  /// Item of a closure with its lookaheads, which are indexed as columns of
+  /// the table. The extra last column stands for lookaheads propagated from
+  /// the kernel item the closure is built from.
+  struct LookaheadItem {
+    Item Dotted;
+    std::vector<bool> Lookaheads;
+  };
+
+  void buildStates();
+
+  /// Finds lookaheads which kernel items generate spontaneously and
+  /// propagates them through the automaton.
+  void computeLookaheads(const LL1Table &First);
+
+  void buildActions(const LL1Table &First);
+
+  /// Returns LR(1) closure of Kernel. Nonkernel items follow kernel ones.
+  std::vector<LookaheadItem>
+  getClosure(const LL1Table &First, std::vector<LookaheadItem> Kernel) const;
+
+  ProductsRange getProducts(uint32_t Rule) const noexcept;
+
+  /// Returns index of the kernel item of State which Dotted becomes after
+  /// its next symbol is read.
+  uint32_t getNextKernelItem(uint32_t State, Item Dotted) const;
+
+  void setAction(uint32_t State, size_t Column, uint32_t Action);
+
+  void fillData();
+
+  const GrammarIndex &Grammar;
+  size_t ColumnsNumber;
+  size_t NonTerminalsNumber;
+  uint32_t AugmentedRule;
+  Symbol AugmentedProducts[1];
+  /// Kernel items of all states, items of state I are
+  /// [KernelOffsets[I], KernelOffsets[I + 1]).
+  std::vector<Item> KernelItems;
+  std::vector<uint32_t> KernelOffsets;
+  std::vector<std::vector<bool>> KernelLookaheads;
+  std::vector<uint32_t> Actions;
+  std::vector<uint32_t> Gotos;
+  std::vector<uint32_t> StateRules;
+  std::vector<int32_t> RuleNonTerminals;
+  std::vector<uint32_t> ProductOffsets;
+  std::vector<int32_t> Products;
+  std::vector<LALRConflict> Conflicts;
+  LALRTableData Data;
+};
+
+} // namespace cb
+
+#endif // COWABUNGA_PARSER_LALRTABLE_H
@@ -0,0 +1,77 @@
+#ifndef COWABUNGA_PARSER_LL1TABLE_H
+#define COWABUNGA_PARSER_LL1TABLE_H
+
+#include "cowabunga/Parser/GrammarIndex.h"
+#include "cowabunga/Parser/ICFGRule.h"
+#include "cowabunga/Parser/Symbol.h"
+
+#include <cstddef>
+#include <vector>
+
+namespace cb {
+
+/// Several rules of NonTerminal may be applied when the next token is
+/// Lookahead.
+struct LL1Conflict final {
+  Symbol NonTerminal;
+  int Lookahead;
+  std::vector<ICFGRule *> Rules;
+};
+
+/// LL1Table is a predict table built from FIRST and FOLLOW sets of a grammar.
+/// For every nonterminal and next token it lists rules which may start a
+/// successful derivation. The grammar is LL(1) if no cell lists more than one
+/// rule.
+class LL1Table final {
+public:
+  /// Lookahead at the end of input.
+  static constexpr int EndOfInput = -1;
+
+  /// Grammar should outlive the table.
+  explicit LL1Table(const GrammarIndex &Grammar);
+
+  /// Returns indices of rules of NonTerminalID which may be applied when the
+  /// next token is Lookahead.
+  const std::vector<size_t> &getPredictedRules(int NonTerminalID,
+                                               int Lookahead) const;
+
+  /// Returns true if the rule may be applied when the next token is
+  /// Lookahead.
+  bool predicts(size_t Rule, int Lookahead) const;
+
+  bool isNullable(int NonTerminalID) const;
+
+  bool isLL1() const noexcept;
+
+  const std::vector<LL1Conflict> &getConflicts() const noexcept;
+
+  /// Adds FIRST of Products[Begin:] to Set, indexed by columns of the table.
+  /// Returns true if that suffix is nullable.
+  bool addFirst(ProductsRange Products, size_t Begin,
+                std::vector<bool> &Set) const;
+
+private:
+  void computeNullable();
+
+  void computeFirst();
+
+  void computeFollow();
+
+  void buildTable();
+
+  size_t getColumn(int Lookahead) const noexcept;
+
+  const GrammarIndex &Grammar;
+  std::vector<bool> Nullable;
+  std::vector<std::vector<bool>> First;
+  std::vector<std::vector<bool>> Follow;
+  /// Column 0 is the end of input, column I + 1 is terminal I.
+  size_t ColumnsNumber;
+  std::vector<std::vector<size_t>> Cells;
+  std::vector<std::vector<bool>> RuleLookaheads;
+  std::vector<LL1Conflict> Conflicts;
+};
+
+} // namespace cb
+
+#endif // COWABUNGA_PARSER_LL1TABLE_H
@@ -1,44 +1,51 @@
 #include "cowabunga/CBC/ASTBuilder.h"
 #include "cowabunga/CBC/ASTNodes.h"
+#include "cowabunga/CBC/Tokenizers.h"
 #include "cowabunga/Lexer/Token.h"
 
 #include <cassert>
 #include <memory>
+#include <string>
 #include <vector>
 
 using namespace cb;
 
+ASTBuilder::ASTBuilder(const SourceManager &SourceManagerRef,
+                       SymbolTable &SymbolTableRef)
+    : Sources(SourceManagerRef), Symbols(SymbolTableRef) {}
+
 void ASTBuilder::createVariable(const Token &Tok) {
-  CreatedExpressions.push_back(std::make_unique<VariableASTNode>(Tok));
+  assert(Tok.getID() == TID_Identifier && "Expected identifier token");
+  auto Symbol = Symbols.intern(Sources.getLexeme(Tok));
+  CreatedExpressions.push_back(
+      std::make_unique<VariableASTNode>(Symbol, Symbols.getName(Symbol)));
 }
 
 void ASTBuilder::createIntegralNumber(const Token &Tok) {
-  CreatedExpressions.push_back((std::make_unique<IntegralNumberASTNode>(Tok)));
+  assert(Tok.getID() == TID_IntegralNumber && "Expected integral number token");
+  CreatedExpressions.push_back(std::make_unique<IntegralNumberASTNode>(
+      std::string(Sources.getLexeme(Tok))));
 }
 
-void ASTBuilder::createCompoundExpression(std::string ExpressionSeparator) {
+void ASTBuilder::createCompoundExpression(
+    std::string_view ExpressionSeparator) {
   assert(!CreatedExpressions.empty() && "There should be at least one Node");
-  std::vector<std::unique_ptr<IASTNode>> ASTNodes;
-  ASTNodes.reserve(CreatedExpressions.size());
-  auto It = CreatedExpressions.rbegin();
-  auto ItEnd = CreatedExpressions.rend();
-  for (; It != ItEnd; ++It) {
-    ASTNodes.push_back(std::move(*It));
-  }
+  std::vector<std::unique_ptr<IASTNode>> ASTNodes =
+      std::move(CreatedExpressions);
   CreatedExpressions.clear();
   CreatedExpressions.push_back(std::make_unique<CompoundExpressionASTNode>(
-      ExpressionSeparator, std::move(ASTNodes)));
+      std::string(ExpressionSeparator), std::move(ASTNodes)));
 }
 
-void ASTBuilder::createAssignmentExpression(std::string Assignment) {
+void ASTBuilder::createAssignmentExpression(std::string_view Assignment) {
   assert(CreatedExpressions.size() >= 2 &&
          "There should be at leas 2 Nodes for Assignment");
-  auto LHS = std::move(CreatedExpressions.back());
-  CreatedExpressions.pop_back();
   auto RHS = std::move(CreatedExpressions.back());
   CreatedExpressions.pop_back();
+  auto LHS = std::move(CreatedExpressions.back());
+  CreatedExpressions.pop_back();
   CreatedExpressions.push_back(std::make_unique<AssignmentExpressionASTNode>(
-      Assignment, std::move(LHS), std::move(RHS)));
+      std::string(Assignment), std::move(LHS), std::move(RHS)));
 }
 
 void ASTBuilder::createParameterList() { CreatedParameterLists.push({}); }
@@ -62,8 +69,9 @@ void ASTBuilder::createFunctionCall(const Token &Tok) {
     Params.push_back(std::move(*It));
   }
   CreatedParameterLists.pop();
-  CreatedExpressions.push_back(
-      std::make_unique<CallExpressionASTNode>(Tok, std::move(Params)));
+  auto Symbol = Symbols.intern(Sources.getLexeme(Tok));
+  CreatedExpressions.push_back(std::make_unique<CallExpressionASTNode>(
+      Symbol, Symbols.getName(Symbol), std::move(Params)));
 }
 
 std::unique_ptr<IASTNode> ASTBuilder::release() {
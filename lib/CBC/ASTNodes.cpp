@@ -1,8 +1,6 @@
 #include "cowabunga/CBC/ASTNodes.h"
 
 #include "cowabunga/CBC/ASTPasses.h"
-#include "cowabunga/CBC/Tokenizers.h"
-#include "cowabunga/Lexer/Token.h"
 
 #include <cassert>
 #include <memory>
@@ -13,9 +11,9 @@ using namespace cb;
 
 IASTNode::~IASTNode() {}
 
-VariableASTNode::VariableASTNode(const Token &Tok) : Name(Tok.getLexeme()) {
-  assert(Tok.getID() == TID_Identifier && "Expected identifier token");
-}
+VariableASTNode::VariableASTNode(SymbolTable::ID VariableSymbol,
+                                 std::string_view VariableName)
+    : Symbol(VariableSymbol), Name(VariableName) {}
 
 void VariableASTNode::acceptASTPass(IASTPass &Pass) { Pass.accept(*this); }
 
@@ -23,10 +21,8 @@ void VariableASTNode::print(std::ostream &Out) const {
   Out << "Variable '" << Name << "'";
 }
 
-IntegralNumberASTNode::IntegralNumberASTNode(const Token &Tok)
-    : Value(Tok.getLexeme()) {
-  assert(Tok.getID() == TID_IntegralNumber && "Expected integral number token");
-}
+IntegralNumberASTNode::IntegralNumberASTNode(std::string NumberValue)
+    : Value(std::move(NumberValue)) {}
 
 void IntegralNumberASTNode::acceptASTPass(IASTPass &Pass) {
   Pass.accept(*this);
@@ -93,14 +89,14 @@ void CompoundExpressionASTNode::print(std::ostream &Out) const {
 }
 
 CallExpressionASTNode::CallExpressionASTNode(
-    const Token &Tok,
+    SymbolTable::ID FunctionSymbol, std::string_view FunctionName,
     std::vector<std::unique_ptr<IASTNode>> ParamsList)
-    : Parameters(std::move(ParamsList)),
-      FuncName(Tok.getLexeme()) {}
+    : Parameters(std::move(ParamsList)), FuncSymbol(FunctionSymbol),
+      FuncName(FunctionName) {}
 
 CallExpressionASTNode::CallExpressionASTNode(
     const CallExpressionASTNode &RHS)
-    : FuncName(RHS.FuncName) {
+    : FuncSymbol(RHS.FuncSymbol), FuncName(RHS.FuncName) {
   Parameters.reserve(RHS.Parameters.size());
   for (auto &Param : RHS.Parameters) {
     Parameters.push_back(Param->clone());
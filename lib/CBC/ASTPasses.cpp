@@ -59,11 +59,43 @@ void ASTPrinter::printTreeBranch() const {
   }
 }
 
-ASTCodeGen::ASTCodeGen()
+ASTSymbolRemapper::ASTSymbolRemapper(
+    const SymbolTable &Symbols, const std::vector<SymbolTable::ID> &NewSymbols)
+    : Symbols(Symbols), NewSymbols(NewSymbols) {}
+
+void ASTSymbolRemapper::accept(VariableASTNode &Node) {
+  assert(Node.Symbol < NewSymbols.size() && "Unknown symbol");
+  Node.Symbol = NewSymbols[Node.Symbol];
+  Node.Name = Symbols.getName(Node.Symbol);
+}
+
+void ASTSymbolRemapper::accept(IntegralNumberASTNode &Node) {}
+
+void ASTSymbolRemapper::accept(AssignmentExpressionASTNode &Node) {
+  Node.LHS->acceptASTPass(*this);
+  Node.RHS->acceptASTPass(*this);
+}
+
+void ASTSymbolRemapper::accept(CompoundExpressionASTNode &Node) {
+  for (auto &Expression : Node.Expressions) {
+    Expression->acceptASTPass(*this);
+  }
+}
+
+void ASTSymbolRemapper::accept(CallExpressionASTNode &Node) {
+  for (auto &Param : Node.Parameters) {
+    Param->acceptASTPass(*this);
+  }
+  assert(Node.FuncSymbol < NewSymbols.size() && "Unknown symbol");
+  Node.FuncSymbol = NewSymbols[Node.FuncSymbol];
+  Node.FuncName = Symbols.getName(Node.FuncSymbol);
+}
+
+ASTCodeGen::ASTCodeGen(SymbolTable &Symbols)
     : Context(), MainModule("Cowabunga", Context), Builder(Context) {
   MainModule.setTargetTriple(llvm::sys::getDefaultTargetTriple());
-  Intrinsics["add"] = &ASTCodeGen::codeGenAdditionIntrinsic;
-  Intrinsics["sub"] = &ASTCodeGen::codeGenSubstractionIntrinsic;
+  addIntrinsic(Symbols, "add", &ASTCodeGen::codeGenAdditionIntrinsic);
+  addIntrinsic(Symbols, "sub", &ASTCodeGen::codeGenSubstractionIntrinsic);
   llvm::FunctionType *FT =
       llvm::FunctionType::get(llvm::Type::getInt32Ty(Context), false);
   F = llvm::Function::Create(FT, llvm::Function::ExternalLinkage, "main",
@@ -73,28 +105,31 @@ ASTCodeGen::ASTCodeGen()
 }
 
 void ASTCodeGen::accept(VariableASTNode &Node) {
-  if (NamedValues.count(Node.Name)) {
-    CodeGeneratedValues.push_back(NamedValues[Node.Name]);
-    LastUsedLValue = &NamedValues[Node.Name];
+  if (Node.Symbol >= NamedValues.size()) {
+    NamedValues.resize(Node.Symbol + 1, nullptr);
+  }
+  LastUsedLValue = Node.Symbol;
+  if (NamedValues[Node.Symbol]) {
+    CodeGeneratedValues.push_back(NamedValues[Node.Symbol]);
     return;
   }
   llvm::Value *Zero = llvm::ConstantInt::get(Context, llvm::APInt(64, "0", 10));
-  NamedValues[Node.Name] = Zero;
-  LastUsedLValue = &NamedValues[Node.Name];
+  NamedValues[Node.Symbol] = Zero;
   CodeGeneratedValues.push_back(Zero);
 }
 
 void ASTCodeGen::accept(IntegralNumberASTNode &Node) {
+  llvm::StringRef Value(Node.Value.data(), Node.Value.size());
   CodeGeneratedValues.push_back(
-      llvm::ConstantInt::get(Context, llvm::APInt(64, Node.Value, 10)));
+      llvm::ConstantInt::get(Context, llvm::APInt(64, Value, 10)));
 }
 
 void ASTCodeGen::accept(AssignmentExpressionASTNode &Node) {
   Node.LHS->acceptASTPass(*this);
-  auto **RefToLValue = LastUsedLValue;
+  auto LValue = LastUsedLValue;
   CodeGeneratedValues.pop_back();
   Node.RHS->acceptASTPass(*this);
-  *RefToLValue = CodeGeneratedValues.back();
+  NamedValues[LValue] = CodeGeneratedValues.back();
 }
 
 void ASTCodeGen::accept(CompoundExpressionASTNode &Node) {
@@ -105,14 +140,14 @@ void ASTCodeGen::accept(CompoundExpressionASTNode &Node) {
 }
 
 void ASTCodeGen::accept(CallExpressionASTNode &Node) {
-  if (Intrinsics.count(Node.FuncName) == 1) {
+  if (Node.FuncSymbol < Intrinsics.size() && Intrinsics[Node.FuncSymbol]) {
     auto OldCodeGeneratedValues = CodeGeneratedValues;
     CodeGeneratedValues.clear();
     for (auto &Param : Node.Parameters) {
       Param->acceptASTPass(*this);
     }
-    auto IntrinsicHandler = Intrinsics[Node.FuncName];
-    auto *ReturnValue = (this->*IntrinsicHandler)(CodeGeneratedValues);
+    auto Handler = Intrinsics[Node.FuncSymbol];
+    auto *ReturnValue = (this->*Handler)(CodeGeneratedValues);
     CodeGeneratedValues = OldCodeGeneratedValues;
     CodeGeneratedValues.push_back(ReturnValue);
   } else {
@@ -120,6 +155,15 @@ void ASTCodeGen::accept(CallExpressionASTNode &Node) {
   }
 }
 
+void ASTCodeGen::addIntrinsic(SymbolTable &Symbols, std::string_view Name,
+                              IntrinsicHandler Handler) {
+  auto Symbol = Symbols.intern(Name);
+  if (Symbol >= Intrinsics.size()) {
+    Intrinsics.resize(Symbol + 1, nullptr);
+  }
+  Intrinsics[Symbol] = Handler;
+}
+
 llvm::Value *
 ASTCodeGen::codeGenAdditionIntrinsic(std::vector<llvm::Value *> Params) {
   auto *LHS = Params.front();
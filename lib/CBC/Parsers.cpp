@@ -1,23 +1,256 @@
 #include "cowabunga/CBC/Parsers.h"
+#include "cowabunga/CBC/ASTPasses.h"
 #include "cowabunga/CBC/Tokenizers.h"
+#include "cowabunga/Common/IClonableMixin.h"
+#include "cowabunga/Common/ThreadPool.h"
 #include "cowabunga/Lexer/Lexer.h"
+#include "cowabunga/Parser/CFGParser.h"
 #include "cowabunga/Parser/CFGParserError.h"
+#include "cowabunga/Parser/ICFGRule.h"
 #include "cowabunga/Parser/Symbol.h"
 
+#include <algorithm>
+#include <cassert>
+#include <functional>
 #include <iostream>
+#include <iterator>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
 
 using namespace cb;
 
 namespace {
 
+// Rules of the script grammar. They build the AST through ASTBuilder, which
+// expects CFGParserActionMode::Streaming, so they're added to parsers only by
+// createScriptParser.
+
+class ParamListToParamList final
+    : public IClonableMixin<ICFGRule, ParamListToParamList> {
+public:
+  ParamListToParamList(const Lexer &LexImpl,
+                                         ASTBuilder &ASTBulderObject);
+
+  void parse(TokenIterator ItToken) override;
+
+  void produceError(CFGParserError Error) override;
+
+  Symbol getLHSNonTerminal() const override;
+
+  std::vector<Symbol> getProducts() const override;
+
+private:
+  const Lexer *Lex;
+  ASTBuilder *Builder;
+};
+
+class ParamListToParam final
+    : public IClonableMixin<ICFGRule, ParamListToParam> {
+public:
+  ParamListToParam(const Lexer &LexImpl,
+                                         ASTBuilder &ASTBulderObject);
+
+  void parse(TokenIterator ItToken) override;
+
+  void produceError(CFGParserError Error) override;
+
+  Symbol getLHSNonTerminal() const override;
+
+  std::vector<Symbol> getProducts() const override;
+
+private:
+  const Lexer *Lex;
+  ASTBuilder *Builder;
+};
+
+class TopLevelExpressionToCompoundExpression final
+    : public IClonableMixin<ICFGRule, TopLevelExpressionToCompoundExpression> {
+public:
+  TopLevelExpressionToCompoundExpression(const Lexer &LexImpl,
+                                         ASTBuilder &ASTBulderObject);
+
+  void parse(TokenIterator ItToken) override;
+
+  void produceError(CFGParserError Error) override;
+
+  Symbol getLHSNonTerminal() const override;
+
+  std::vector<Symbol> getProducts() const override;
+
+private:
+  const Lexer *Lex;
+  ASTBuilder *Builder;
+};
+
+class CompoundExpressionToExpressionSequence final
+    : public IClonableMixin<ICFGRule, CompoundExpressionToExpressionSequence> {
+public:
+  CompoundExpressionToExpressionSequence(const Lexer &LexImpl,
+                                         ASTBuilder &ASTBulderObject);
+
+  void parse(TokenIterator ItToken) override;
+
+  void produceError(CFGParserError Error) override;
+
+  Symbol getLHSNonTerminal() const override;
+
+  std::vector<Symbol> getProducts() const override;
+
+private:
+  const Lexer *Lex;
+  ASTBuilder *Builder;
+};
+
+class CompoundExpressionToSingleExpression final
+    : public IClonableMixin<ICFGRule, CompoundExpressionToSingleExpression> {
+public:
+  CompoundExpressionToSingleExpression(const Lexer &LexImpl,
+                                       ASTBuilder &ASTBulderObject);
+
+  void parse(TokenIterator ItToken) override;
+
+  void produceError(CFGParserError Error) override;
+
+  Symbol getLHSNonTerminal() const override;
+
+  std::vector<Symbol> getProducts() const override;
+
+private:
+  const Lexer *Lex;
+  ASTBuilder *Builder;
+};
+
+class ExpressionToAssignment final
+    : public IClonableMixin<ICFGRule, ExpressionToAssignment> {
+public:
+  ExpressionToAssignment(const Lexer &LexImpl, ASTBuilder &ASTBulderObject);
+
+  void parse(TokenIterator ItToken) override;
+
+  void produceError(CFGParserError Error) override;
+
+  Symbol getLHSNonTerminal() const override;
+
+  std::vector<Symbol> getProducts() const override;
+
+private:
+  const Lexer *Lex;
+  ASTBuilder *Builder;
+};
+
+class ExpressionToRValue final
+    : public IClonableMixin<ICFGRule, ExpressionToRValue> {
+public:
+  ExpressionToRValue(const Lexer &LexImpl, ASTBuilder &ASTBulderObject);
+
+  void parse(TokenIterator ItToken) override;
+
+  void produceError(CFGParserError Error) override;
+
+  Symbol getLHSNonTerminal() const override;
+
+  std::vector<Symbol> getProducts() const override;
+
+private:
+  const Lexer *Lex;
+  ASTBuilder *Builder;
+};
+
+class RValueToCall final : public IClonableMixin<ICFGRule, RValueToCall> {
+public:
+  RValueToCall(const Lexer &LexImpl, ASTBuilder &ASTBulderObject);
+
+  void parse(TokenIterator ItToken) override;
+
+  void produceError(CFGParserError Error) override;
+
+  Symbol getLHSNonTerminal() const override;
+
+  std::vector<Symbol> getProducts() const override;
+
+private:
+  const Lexer *Lex;
+  ASTBuilder *Builder;
+};
+
+class RValueToLValue final : public IClonableMixin<ICFGRule, RValueToLValue> {
+public:
+  RValueToLValue(const Lexer &LexImpl, ASTBuilder &ASTBulderObject);
+
+  void parse(TokenIterator ItToken) override;
+
+  void produceError(CFGParserError Error) override;
+
+  Symbol getLHSNonTerminal() const override;
+
+  std::vector<Symbol> getProducts() const override;
+
+private:
+  const Lexer *Lex;
+  ASTBuilder *Builder;
+};
+
+class RValueToIntegralNumber final
+    : public IClonableMixin<ICFGRule, RValueToIntegralNumber> {
+public:
+  RValueToIntegralNumber(const Lexer &LexImpl, ASTBuilder &ASTBulderObject);
+
+  void parse(TokenIterator ItToken) override;
+
+  void produceError(CFGParserError Error) override;
+
+  Symbol getLHSNonTerminal() const override;
+
+  std::vector<Symbol> getProducts() const override;
+
+private:
+  const Lexer *Lex;
+  ASTBuilder *Builder;
+};
+
+class LValueToIdentifier final
+    : public IClonableMixin<ICFGRule, LValueToIdentifier> {
+public:
+  LValueToIdentifier(const Lexer &LexImpl, ASTBuilder &ASTBulderObject);
+
+  void parse(TokenIterator ItToken) override;
+
+  void produceError(CFGParserError Error) override;
+
+  Symbol getLHSNonTerminal() const override;
+
+  std::vector<Symbol> getProducts() const override;
+
+private:
+  const Lexer *Lex;
+  ASTBuilder *Builder;
+};
+
+/// Scripts are split into chunks of at least this many tokens, smaller ones
+/// aren't worth starting a thread.
+constexpr size_t MinParallelChunkSize = 1 << 16;
+
+/// Set on threads which parse chunks of a script. Syntax errors are only
+/// noted there, the whole script is parsed again to report them.
+thread_local bool *ChunkFailed = nullptr;
+
 void printError(CFGParserError Error, const Lexer &Lex) {
+  if (ChunkFailed) {
+    *ChunkFailed = true;
+    return;
+  }
+  auto &Sources = Lex.getSourceManager();
   auto LastToken = Error.ItFoundToken;
-  auto ColumnNumber = LastToken->BeginColumnNumber;
+  auto BeginColumnNumber = Sources.getColumnNumber(*LastToken);
+  auto ColumnNumber = BeginColumnNumber;
   if (Error.EOFFound) {
-    ColumnNumber = LastToken->EndColumnNumber;
+    ColumnNumber = BeginColumnNumber + LastToken->Length;
   }
-  std::cerr << LastToken->getFile() << ":" << LastToken->LineNumber << ":"
-            << ColumnNumber << ": unexpected token\n";
+  std::cerr << Sources.getFile(*LastToken) << ":"
+            << Sources.getLineNumber(*LastToken) << ":" << ColumnNumber
+            << ": unexpected token\n";
   if (Error.EOFFound) {
     std::cerr << "\t";
     if (Error.ExpectedSymbol.isTerminal()) {
@@ -30,28 +263,76 @@ void printError(CFGParserError Error, const Lexer &Lex) {
     exit(2);
   }
   if (Error.EOFExpected) {
-    std::cerr << "\t" << Error.ItFoundToken->getLine() << "\n\t";
-    for (size_t I = 0; I < Error.ItFoundToken->BeginColumnNumber - 1; ++I) {
+    std::cerr << "\t" << Sources.getLine(*LastToken) << "\n\t";
+    for (size_t I = 0; I < BeginColumnNumber - 1; ++I) {
       std::cerr << " ";
     }
     std::cerr << "^\n";
-    std::cerr << "expected EOF, found " << Error.ItFoundToken->getLexeme()
+    std::cerr << "expected EOF, found " << Sources.getLexeme(*LastToken)
               << "\n";
     exit(2);
   }
-  std::cerr << "\t" << Error.ItFoundToken->getLine() << "\n\t";
-  for (size_t I = 0; I < Error.ItFoundToken->BeginColumnNumber - 1; ++I) {
+  std::cerr << "\t" << Sources.getLine(*LastToken) << "\n\t";
+  for (size_t I = 0; I < BeginColumnNumber - 1; ++I) {
     std::cerr << " ";
   }
   std::cerr << "^\n";
   std::cerr << "expected "
             << Lex.getTokenLexeme(
                    static_cast<TokenID>(Error.ExpectedSymbol.getID()))
-            << ", found " << Error.ItFoundToken->getLexeme() << "\n";
+            << ", found " << Sources.getLexeme(*LastToken) << "\n";
   exit(2);
 }
 
-} // namespace
+/// Returns offsets [0, B1, ..., ItEnd - ItBegin] which split tokens into at
+/// most ChunksNumber chunks of whole top-level statements of about equal
+/// size. Separators inside parentheses don't end statements.
+std::vector<size_t> splitIntoStatementChunks(TokenIterator ItBegin,
+                                             TokenIterator ItEnd,
+                                             size_t ChunksNumber) {
+  size_t Length = ItEnd - ItBegin;
+  std::vector<size_t> Bounds{0};
+  int Depth = 0;
+  for (size_t I = 0; I + 1 < Length && Bounds.size() < ChunksNumber; ++I) {
+    switch (ItBegin[I].getID()) {
+    case TID_OpenParantheses:
+      ++Depth;
+      break;
+    case TID_CloseParantheses:
+      --Depth;
+      break;
+    case TID_ExpressionSeparator:
+      if (Depth <= 0 && I + 1 >= Length / ChunksNumber * Bounds.size()) {
+        Bounds.push_back(I + 1);
+      }
+      break;
+    default:
+      break;
+    }
+  }
+  Bounds.push_back(Length);
+  return Bounds;
+}
+
+/// Returns AST of the script, or nullptr if the script is parsed on a chunk
+/// thread and has a syntax error.
+std::unique_ptr<IASTNode> parseChunk(const Lexer &LexImpl,
+                                     SymbolTable &Symbols,
+                                     TokenIterator ItBegin,
+                                     TokenIterator ItEnd,
+                                     const LALRTableData *Table) {
+  ASTBuilder Builder(LexImpl.getSourceManager(), Symbols);
+  auto Parser = createScriptParser(LexImpl, Builder);
+  Parser.setAlgorithm(CFGParserAlgorithm::LALR);
+  if (!Table || !Parser.setLALRTable(*Table)) {
+    Parser.compile();
+  }
+  Parser.parse(ItBegin, ItEnd);
+  if (ChunkFailed && *ChunkFailed) {
+    return nullptr;
+  }
+  return Builder.release();
+}
 
 ParamListToParamList::ParamListToParamList(const Lexer &LexImpl,
                                            ASTBuilder &ASTBulderObject)
@@ -273,3 +554,123 @@ Symbol LValueToIdentifier::getLHSNonTerminal() const {
 std::vector<Symbol> LValueToIdentifier::getProducts() const {
   return {Symbol(TID_Identifier)};
 }
+
+} // namespace
+
+KeywordSetTokenizer cb::createScriptKeywords() {
+  return KeywordSetTokenizer({{TID_ExpressionSeparator, ";"},
+                              {TID_Assignment, "="},
+                              {TID_OpenParantheses, "("},
+                              {TID_CloseParantheses, ")"},
+                              {TID_ArgumentSeparator, ","}});
+}
+
+Lexer cb::createScriptLexer() {
+  Lexer Lex;
+  Lex.addTokenizer(IdentifierTokenizer())
+      .addTokenizer(IntegralNumberTokenizer())
+      .addTokenizer(createScriptKeywords());
+  return Lex;
+}
+
+CFGParser cb::createScriptParser(const Lexer &LexImpl,
+                                 ASTBuilder &ASTBulderObject) {
+  CFGParser Parser(nonTerminal(NTID_TopLevelExpression));
+  Parser.addCFGRule(LValueToIdentifier(LexImpl, ASTBulderObject))
+      .addCFGRule(RValueToLValue(LexImpl, ASTBulderObject))
+      .addCFGRule(RValueToIntegralNumber(LexImpl, ASTBulderObject))
+      .addCFGRule(ExpressionToRValue(LexImpl, ASTBulderObject))
+      .addCFGRule(CompoundExpressionToSingleExpression(LexImpl,
+                                                       ASTBulderObject))
+      .addCFGRule(CompoundExpressionToExpressionSequence(LexImpl,
+                                                         ASTBulderObject))
+      .addCFGRule(TopLevelExpressionToCompoundExpression(LexImpl,
+                                                         ASTBulderObject))
+      .addCFGRule(ExpressionToAssignment(LexImpl, ASTBulderObject))
+      .addCFGRule(RValueToCall(LexImpl, ASTBulderObject))
+      .addCFGRule(ParamListToParam(LexImpl, ASTBulderObject))
+      .addCFGRule(ParamListToParamList(LexImpl, ASTBulderObject));
+  Parser.setActionMode(CFGParserActionMode::Streaming);
+  return Parser;
+}
+
+std::unique_ptr<IASTNode> cb::parseScript(const Lexer &LexImpl,
+                                          SymbolTable &Symbols,
+                                          TokenIterator ItBegin,
+                                          TokenIterator ItEnd,
+                                          const LALRTableData *Table,
+                                          unsigned ThreadsNumber) {
+  if (ThreadsNumber == 0) {
+    ThreadsNumber = std::max(1U, std::thread::hardware_concurrency());
+  }
+  size_t ChunksNumber = std::min<size_t>(
+      ThreadsNumber, (ItEnd - ItBegin) / MinParallelChunkSize);
+  if (ChunksNumber <= 1) {
+    return parseChunk(LexImpl, Symbols, ItBegin, ItEnd, Table);
+  }
+  auto Bounds = splitIntoStatementChunks(ItBegin, ItEnd, ChunksNumber);
+  ChunksNumber = Bounds.size() - 1;
+  if (ChunksNumber == 1) {
+    return parseChunk(LexImpl, Symbols, ItBegin, ItEnd, Table);
+  }
+
+  // Chunks share LALR(1) tables rather than build them each.
+  std::unique_ptr<LALRTable> ScriptTable;
+  if (!Table) {
+    SymbolTable TableSymbols;
+    ASTBuilder TableBuilder(LexImpl.getSourceManager(), TableSymbols);
+    auto Parser = createScriptParser(LexImpl, TableBuilder);
+    ScriptTable = std::make_unique<LALRTable>(Parser.getGrammarIndex());
+    Table = &ScriptTable->getData();
+  }
+
+  // Every chunk interns its names into its own table, IDs are remapped to
+  // Symbols once all chunks are parsed.
+  std::vector<SymbolTable> ChunkSymbols(ChunksNumber);
+  std::vector<std::unique_ptr<IASTNode>> ChunkASTs(ChunksNumber);
+  std::vector<char> Failed(ChunksNumber, false);
+  auto ParseChunk = [&](size_t Chunk) {
+    bool ChunkError = false;
+    ChunkFailed = &ChunkError;
+    ChunkASTs[Chunk] =
+        parseChunk(LexImpl, ChunkSymbols[Chunk], ItBegin + Bounds[Chunk],
+                   ItBegin + Bounds[Chunk + 1], Table);
+    ChunkFailed = nullptr;
+    Failed[Chunk] = ChunkError;
+  };
+  auto RunOnChunks = [ChunksNumber](
+                         const std::function<void(size_t)> &Job) {
+    ThreadPool::getShared().run(ChunksNumber, ChunksNumber, Job);
+  };
+  RunOnChunks(ParseChunk);
+  if (std::find(Failed.begin(), Failed.end(), true) != Failed.end()) {
+    // Errors are reported as if the script were parsed on one thread.
+    return parseChunk(LexImpl, Symbols, ItBegin, ItEnd, Table);
+  }
+
+  // Chunks are interned in source order, so IDs are the same as if the
+  // script were parsed on one thread.
+  std::vector<std::vector<SymbolTable::ID>> NewSymbols(ChunksNumber);
+  for (size_t Chunk = 0; Chunk < ChunksNumber; ++Chunk) {
+    auto &ChunkTable = ChunkSymbols[Chunk];
+    for (SymbolTable::ID ID = 0; ID < ChunkTable.size(); ++ID) {
+      NewSymbols[Chunk].push_back(Symbols.intern(ChunkTable.getName(ID)));
+    }
+  }
+  RunOnChunks([&](size_t Chunk) {
+    ASTSymbolRemapper Remapper(Symbols, NewSymbols[Chunk]);
+    ChunkASTs[Chunk]->acceptASTPass(Remapper);
+  });
+
+  std::vector<std::unique_ptr<IASTNode>> Statements;
+  for (auto &AST : ChunkASTs) {
+    assert(dynamic_cast<CompoundExpressionASTNode *>(AST.get()) &&
+           "Chunk should be parsed into a compound expression");
+    auto &Compound = static_cast<CompoundExpressionASTNode &>(*AST);
+    std::move(Compound.Expressions.begin(), Compound.Expressions.end(),
+              std::back_inserter(Statements));
+  }
+  return std::make_unique<CompoundExpressionASTNode>(
+      std::string(LexImpl.getTokenLexeme(TID_ExpressionSeparator)),
+      std::move(Statements));
+}
@@ -1,26 +1,71 @@
 #include "cowabunga/CBC/Tokenizers.h"
 
+#include "cowabunga/Lexer/CharScanners.h"
+#include "cowabunga/Lexer/Unicode.h"
+
+#include <algorithm>
+#include <cassert>
+#include <map>
 #include <optional>
 #include <string_view>
 #include <utility>
 
 using namespace cb;
 
+namespace {
+
+/// Implements ITokenizer::tokenize of tokenizers that provide matchLength and
+/// buildToken.
+std::pair<std::optional<Token>, size_t> tokenizeByMatch(ITokenizer &Tokenizer,
+                                                        std::string_view Word) {
+  size_t Length = Tokenizer.matchLength(Word);
+  if (!Length) {
+    return std::make_pair(std::nullopt, 0);
+  }
+  return std::make_pair(Tokenizer.buildToken(Word.substr(0, Length)), Length);
+}
+
+} // namespace
+
 std::pair<std::optional<Token>, size_t>
 IdentifierTokenizer::tokenize(std::string_view Word) {
-  auto *It = Word.cbegin();
-  bool Match = It != Word.cend() && (std::isalpha(*It) || *It == '_');
-  while (Match && It != Word.cend()) {
-    Match = std::isalnum(*It) || *It == '_';
-    if (Match) {
-      ++It;
+  return tokenizeByMatch(*this, Word);
+}
+
+size_t IdentifierTokenizer::matchLength(std::string_view Word) {
+  if (Word.empty()) {
+    return 0;
+  }
+  size_t Length = 0;
+  if (static_cast<unsigned char>(Word.front()) < 0x80) {
+    if (!isIdentifierStart(Word.front())) {
+      return 0;
+    }
+    Length = scanIdentifierChars(Word);
+  } else {
+    auto [CodePoint, CodePointLength] = decodeUTF8(Word);
+    if (!CodePointLength || !isXIDStart(CodePoint)) {
+      return 0;
     }
+    Length = CodePointLength;
+    Length += scanIdentifierChars(Word.substr(Length));
   }
-  if (It == Word.cbegin()) {
-    return std::make_pair(std::nullopt, 0);
+  // ASCII identifiers end here, others are decoded character by character
+  // between ASCII runs.
+  while (Length < Word.length() &&
+         static_cast<unsigned char>(Word[Length]) >= 0x80) {
+    auto [CodePoint, CodePointLength] = decodeUTF8(Word.substr(Length));
+    if (!CodePointLength || !isXIDContinue(CodePoint)) {
+      break;
+    }
+    Length += CodePointLength;
+    Length += scanIdentifierChars(Word.substr(Length));
   }
-  auto Result = Token(TID_Identifier);
-  return std::make_pair(Result, It - Word.cbegin());
+  return Length;
+}
+
+Token IdentifierTokenizer::buildToken(std::string_view) {
+  return Token(TID_Identifier);
 }
 
 int IdentifierTokenizer::getTokenID() const {
@@ -31,21 +76,26 @@ std::string IdentifierTokenizer::getLexemeString() const {
   return "identifier";
 }
 
+std::vector<TokenPattern> IdentifierTokenizer::getPatterns() const {
+  auto Letters = CharSet::range('a', 'z')
+                     .add(CharSet::range('A', 'Z'))
+                     .add(CharSet::of("_"));
+  auto LettersAndDigits = Letters;
+  LettersAndDigits.add(CharSet::range('0', '9'));
+  return {TokenPattern(TID_Identifier).one(Letters).many(LettersAndDigits)};
+}
+
 std::pair<std::optional<Token>, size_t>
 IntegralNumberTokenizer::tokenize(std::string_view Word) {
-  bool Match = true;
-  auto *It = Word.cbegin();
-  while (Match && It != Word.cend()) {
-    Match = std::isdigit(*It);
-    if (Match) {
-      ++It;
-    }
-  }
-  if (It == Word.cbegin()) {
-    return std::make_pair(std::nullopt, 0);
-  }
-  auto Result = Token(TID_IntegralNumber);
-  return std::make_pair(Result, It - Word.cbegin());
+  return tokenizeByMatch(*this, Word);
+}
+
+size_t IntegralNumberTokenizer::matchLength(std::string_view Word) {
+  return scanDigits(Word);
+}
+
+Token IntegralNumberTokenizer::buildToken(std::string_view) {
+  return Token(TID_IntegralNumber);
 }
 
 int IntegralNumberTokenizer::getTokenID() const {
@@ -56,18 +106,28 @@ std::string IntegralNumberTokenizer::getLexemeString() const {
   return "integer";
 }
 
+std::vector<TokenPattern> IntegralNumberTokenizer::getPatterns() const {
+  auto Digits = CharSet::range('0', '9');
+  return {TokenPattern(TID_IntegralNumber).one(Digits).many(Digits)};
+}
+
 KeywordTokenizer::KeywordTokenizer(TokenID TokID, std::string Keyword)
     : ID(TokID), KeywordString(std::move(Keyword)) {}
 
 std::pair<std::optional<Token>, size_t>
 KeywordTokenizer::tokenize(std::string_view Word) {
-  if (Word.find(KeywordString)) {
-    return std::make_pair(std::nullopt, 0);
+  return tokenizeByMatch(*this, Word);
+}
+
+size_t KeywordTokenizer::matchLength(std::string_view Word) {
+  if (Word.compare(0, KeywordString.length(), KeywordString)) {
+    return 0;
   }
-  auto Result = Token(ID);
-  return std::make_pair(Result, KeywordString.length());
+  return KeywordString.length();
 }
 
+Token KeywordTokenizer::buildToken(std::string_view) { return Token(ID); }
+
 int KeywordTokenizer::getTokenID() const {
   return ID;
 }
@@ -75,3 +135,127 @@ int KeywordTokenizer::getTokenID() const {
 std::string KeywordTokenizer::getLexemeString() const {
   return KeywordString;
 }
+
+std::vector<TokenPattern> KeywordTokenizer::getPatterns() const {
+  if (KeywordString.empty()) {
+    return {};
+  }
+  return {TokenPattern::literal(ID, KeywordString)};
+}
+
+KeywordSetTokenizer::KeywordSetTokenizer(
+    std::vector<std::pair<TokenID, std::string>> Keywords)
+    : KeywordTable(std::move(Keywords)) {
+  assert(!KeywordTable.empty() && "There should be at least one keyword");
+  buildTrie();
+}
+
+std::pair<std::optional<Token>, size_t>
+KeywordSetTokenizer::tokenize(std::string_view Word) {
+  return tokenizeByMatch(*this, Word);
+}
+
+size_t KeywordSetTokenizer::matchLength(std::string_view Word) {
+  return findBestKeyword(Word).second;
+}
+
+Token KeywordSetTokenizer::buildToken(std::string_view Lexeme) {
+  auto [Node, Length] = findBestKeyword(Lexeme);
+  assert(Length == Lexeme.length() && "Lexeme should be a keyword");
+  return Token(Nodes[Node].ID);
+}
+
+std::pair<uint32_t, size_t>
+KeywordSetTokenizer::findBestKeyword(std::string_view Word) const {
+  if (Word.empty()) {
+    return std::make_pair(0, 0);
+  }
+  uint32_t Node = RootChildren[static_cast<unsigned char>(Word.front())];
+  uint32_t BestNode = 0;
+  size_t BestLength = 0;
+  for (size_t Length = 1; Node; ++Length) {
+    if (Nodes[Node].Terminal &&
+        (!BestNode || Nodes[BestNode].ID <= Nodes[Node].ID)) {
+      BestNode = Node;
+      BestLength = Length;
+    }
+    if (Length == Word.length()) {
+      break;
+    }
+    auto *ItBegin = NodeChars.data() + Nodes[Node].FirstChild;
+    auto *ItEnd = ItBegin + Nodes[Node].ChildrenNumber;
+    auto *It = std::find(ItBegin, ItEnd, Word[Length]);
+    Node = It == ItEnd ? 0 : Nodes[Node].FirstChild + (It - ItBegin);
+  }
+  return std::make_pair(BestNode, BestLength);
+}
+
+int KeywordSetTokenizer::getTokenID() const {
+  return KeywordTable.front().first;
+}
+
+std::string KeywordSetTokenizer::getLexemeString() const {
+  return KeywordTable.front().second;
+}
+
+std::vector<std::pair<int, std::string>>
+KeywordSetTokenizer::getLexemeStrings() const {
+  std::vector<std::pair<int, std::string>> LexemeStrings;
+  for (auto &[ID, Keyword] : KeywordTable) {
+    LexemeStrings.emplace_back(ID, Keyword);
+  }
+  return LexemeStrings;
+}
+
+std::vector<TokenPattern> KeywordSetTokenizer::getPatterns() const {
+  std::vector<TokenPattern> Patterns;
+  for (auto &[ID, Keyword] : KeywordTable) {
+    Patterns.push_back(TokenPattern::literal(ID, Keyword));
+  }
+  return Patterns;
+}
+
+void KeywordSetTokenizer::buildTrie() {
+  struct BuilderNode {
+    std::map<char, size_t> Children;
+    int ID = 0;
+    bool Terminal = false;
+  };
+  std::vector<BuilderNode> Trie(1);
+  for (auto &[ID, Keyword] : KeywordTable) {
+    assert(!Keyword.empty() && "Keyword shouldn't be empty");
+    size_t Node = 0;
+    for (char Char : Keyword) {
+      auto It = Trie[Node].Children.find(Char);
+      if (It == Trie[Node].Children.end()) {
+        It = Trie[Node].Children.emplace(Char, Trie.size()).first;
+        Trie.emplace_back();
+      }
+      Node = It->second;
+    }
+    assert(!Trie[Node].Terminal && "Keywords should be unique");
+    Trie[Node].ID = ID;
+    Trie[Node].Terminal = true;
+  }
+  // Lay nodes out in breadth-first order, so that children of each node are
+  // stored contiguously. Index 0 is reserved for the root, which is never
+  // reached by findBestKeyword, so it doubles as "no node".
+  std::vector<size_t> Order{0};
+  Nodes.assign(1, TrieNode{1, 0, 0, false});
+  NodeChars.assign(1, '\0');
+  for (size_t I = 0; I < Order.size(); ++I) {
+    auto &Source = Trie[Order[I]];
+    Nodes[I].FirstChild = static_cast<uint32_t>(Order.size());
+    Nodes[I].ChildrenNumber = static_cast<uint32_t>(Source.Children.size());
+    for (auto &[Char, Child] : Source.Children) {
+      Order.push_back(Child);
+      Nodes.push_back(TrieNode{0, 0, Trie[Child].ID, Trie[Child].Terminal});
+      NodeChars.push_back(Char);
+    }
+  }
+  RootChildren.fill(0);
+  for (uint32_t I = 0; I < Nodes[0].ChildrenNumber; ++I) {
+    uint32_t Child = Nodes[0].FirstChild + I;
+    RootChildren[static_cast<unsigned char>(NodeChars[Child])] = Child;
+  }
+}
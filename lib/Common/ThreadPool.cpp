@@ -0,0 +1,74 @@
+#include "cowabunga/Common/ThreadPool.h"
+
+using namespace cb;
+
+ThreadPool::~ThreadPool() {
+  {
+    std::lock_guard<std::mutex> RunLock(RunMutex);
+    std::lock_guard<std::mutex> Lock(Mutex);
+    Stopping = true;
+  }
+  BatchStarted.notify_all();
+  for (auto &Worker : Workers) {
+    Worker.join();
+  }
+}
+
+void ThreadPool::run(size_t NewJobsNumber, unsigned ThreadsNumber,
+                     const std::function<void(size_t)> &NewJob) {
+  std::lock_guard<std::mutex> RunLock(RunMutex);
+  size_t Helpers = ThreadsNumber ? ThreadsNumber - 1 : 0;
+  if (NewJobsNumber < Helpers + 1) {
+    Helpers = NewJobsNumber ? NewJobsNumber - 1 : 0;
+  }
+  while (Workers.size() < Helpers) {
+    Workers.emplace_back(&ThreadPool::work, this);
+  }
+  std::unique_lock<std::mutex> Lock(Mutex);
+  Job = &NewJob;
+  NextJob = 0;
+  JobsNumber = NewJobsNumber;
+  FreeSlots = Helpers;
+  Lock.unlock();
+  BatchStarted.notify_all();
+  Lock.lock();
+  runJobs(Lock);
+  JobsFinished.wait(Lock, [this] { return !JobsRunning; });
+  // Workers which haven't woken up yet mustn't join the finished batch.
+  FreeSlots = 0;
+  Job = nullptr;
+}
+
+ThreadPool &ThreadPool::getShared() {
+  // The pool is never destroyed, so exit doesn't wait for its workers.
+  static ThreadPool *Shared = new ThreadPool();
+  return *Shared;
+}
+
+void ThreadPool::runJobs(std::unique_lock<std::mutex> &Lock) {
+  while (NextJob < JobsNumber) {
+    size_t Current = NextJob++;
+    ++JobsRunning;
+    Lock.unlock();
+    (*Job)(Current);
+    Lock.lock();
+    --JobsRunning;
+  }
+  if (!JobsRunning) {
+    JobsFinished.notify_all();
+  }
+}
+
+void ThreadPool::work() {
+  std::unique_lock<std::mutex> Lock(Mutex);
+  while (true) {
+    BatchStarted.wait(Lock, [this] {
+      return Stopping || (FreeSlots && NextJob < JobsNumber);
+    });
+    if (Stopping) {
+      return;
+    }
+    --FreeSlots;
+    runJobs(Lock);
+  }
+}
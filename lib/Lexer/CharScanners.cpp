@@ -0,0 +1,269 @@
+#include "cowabunga/Lexer/CharScanners.h"
+
+#include <array>
+#include <cstdint>
+#include <vector>
+
+#if (defined(__x86_64__) || defined(__i386__)) && defined(__SSE2__) &&       \
+    defined(__GNUC__)
+#include <immintrin.h>
+#define COWABUNGA_X86_SIMD 1
+#endif
+
+using namespace cb;
+
+namespace {
+
+enum class ScanKind { Whitespace, NonWhitespace, Identifier, Digits, ASCII };
+
+enum CharClass : uint8_t {
+  CC_Whitespace = 1 << 0,
+  CC_Digit = 1 << 1,
+  CC_IdentifierStart = 1 << 2,
+  CC_Identifier = 1 << 3
+};
+
+constexpr std::array<uint8_t, 256> makeCharClasses() {
+  std::array<uint8_t, 256> Classes{};
+  Classes[' '] = Classes['\t'] = CC_Whitespace;
+  for (unsigned Char = '0'; Char <= '9'; ++Char) {
+    Classes[Char] = CC_Digit | CC_Identifier;
+  }
+  for (unsigned Char = 'a'; Char <= 'z'; ++Char) {
+    Classes[Char] = Classes[Char - 'a' + 'A'] =
+        CC_IdentifierStart | CC_Identifier;
+  }
+  Classes['_'] = CC_IdentifierStart | CC_Identifier;
+  return Classes;
+}
+
+constexpr std::array<uint8_t, 256> CharClasses = makeCharClasses();
+
+template <ScanKind Kind> bool matchScalar(char Char) {
+  uint8_t Class = CharClasses[static_cast<unsigned char>(Char)];
+  if constexpr (Kind == ScanKind::Whitespace) {
+    return Class & CC_Whitespace;
+  } else if constexpr (Kind == ScanKind::NonWhitespace) {
+    return !(Class & CC_Whitespace);
+  } else if constexpr (Kind == ScanKind::Identifier) {
+    return Class & CC_Identifier;
+  } else if constexpr (Kind == ScanKind::Digits) {
+    return Class & CC_Digit;
+  } else {
+    return static_cast<unsigned char>(Char) < 0x80;
+  }
+}
+
+template <ScanKind Kind> size_t scanScalar(const char *Data, size_t Size) {
+  size_t I = 0;
+  while (I < Size && matchScalar<Kind>(Data[I])) {
+    ++I;
+  }
+  return I;
+}
+
+void findLineStartsScalar(const char *Data, size_t Size,
+                          std::vector<size_t> &LineStarts) {
+  for (size_t I = 0; I < Size; ++I) {
+    if (Data[I] == '\n') {
+      LineStarts.push_back(I + 1);
+    }
+  }
+}
+
+#ifdef COWABUNGA_X86_SIMD
+
+/// Returns mask with 0xFF in bytes that are in range [Low, Low + Width].
+inline __m128i inRangeSSE2(__m128i Chars, char Low, char Width) {
+  __m128i Shifted = _mm_sub_epi8(Chars, _mm_set1_epi8(Low));
+  return _mm_cmpeq_epi8(_mm_min_epu8(Shifted, _mm_set1_epi8(Width)), Shifted);
+}
+
+template <ScanKind Kind> __m128i matchSSE2(__m128i Chars) {
+  if constexpr (Kind == ScanKind::Whitespace ||
+                Kind == ScanKind::NonWhitespace) {
+    return _mm_or_si128(_mm_cmpeq_epi8(Chars, _mm_set1_epi8(' ')),
+                        _mm_cmpeq_epi8(Chars, _mm_set1_epi8('\t')));
+  } else if constexpr (Kind == ScanKind::Identifier) {
+    __m128i Lower = _mm_or_si128(Chars, _mm_set1_epi8(0x20));
+    return _mm_or_si128(
+        _mm_or_si128(inRangeSSE2(Lower, 'a', 'z' - 'a'),
+                     inRangeSSE2(Chars, '0', '9' - '0')),
+        _mm_cmpeq_epi8(Chars, _mm_set1_epi8('_')));
+  } else if constexpr (Kind == ScanKind::Digits) {
+    return inRangeSSE2(Chars, '0', '9' - '0');
+  } else {
+    return _mm_cmpgt_epi8(Chars, _mm_set1_epi8(-1));
+  }
+}
+
+template <ScanKind Kind> size_t scanSSE2(const char *Data, size_t Size) {
+  constexpr unsigned InvertMask = Kind == ScanKind::NonWhitespace ? 0 : 0xFFFF;
+  size_t I = 0;
+  for (; I + 16 <= Size; I += 16) {
+    __m128i Chars =
+        _mm_loadu_si128(reinterpret_cast<const __m128i *>(Data + I));
+    unsigned Mismatches =
+        (_mm_movemask_epi8(matchSSE2<Kind>(Chars)) ^ InvertMask) & 0xFFFF;
+    if (Mismatches) {
+      return I + __builtin_ctz(Mismatches);
+    }
+  }
+  return I + scanScalar<Kind>(Data + I, Size - I);
+}
+
+void findLineStartsSSE2(const char *Data, size_t Size,
+                        std::vector<size_t> &LineStarts) {
+  const __m128i Newline = _mm_set1_epi8('\n');
+  size_t I = 0;
+  for (; I + 16 <= Size; I += 16) {
+    __m128i Chars =
+        _mm_loadu_si128(reinterpret_cast<const __m128i *>(Data + I));
+    for (unsigned Mask = _mm_movemask_epi8(_mm_cmpeq_epi8(Chars, Newline));
+         Mask; Mask &= Mask - 1) {
+      LineStarts.push_back(I + __builtin_ctz(Mask) + 1);
+    }
+  }
+  size_t Tail = LineStarts.size();
+  findLineStartsScalar(Data + I, Size - I, LineStarts);
+  for (; Tail < LineStarts.size(); ++Tail) {
+    LineStarts[Tail] += I;
+  }
+}
+
+__attribute__((target("avx2"))) inline __m256i
+inRangeAVX2(__m256i Chars, char Low, char Width) {
+  __m256i Shifted = _mm256_sub_epi8(Chars, _mm256_set1_epi8(Low));
+  return _mm256_cmpeq_epi8(_mm256_min_epu8(Shifted, _mm256_set1_epi8(Width)),
+                           Shifted);
+}
+
+template <ScanKind Kind>
+__attribute__((target("avx2"))) __m256i matchAVX2(__m256i Chars) {
+  if constexpr (Kind == ScanKind::Whitespace ||
+                Kind == ScanKind::NonWhitespace) {
+    return _mm256_or_si256(_mm256_cmpeq_epi8(Chars, _mm256_set1_epi8(' ')),
+                           _mm256_cmpeq_epi8(Chars, _mm256_set1_epi8('\t')));
+  } else if constexpr (Kind == ScanKind::Identifier) {
+    __m256i Lower = _mm256_or_si256(Chars, _mm256_set1_epi8(0x20));
+    return _mm256_or_si256(
+        _mm256_or_si256(inRangeAVX2(Lower, 'a', 'z' - 'a'),
+                        inRangeAVX2(Chars, '0', '9' - '0')),
+        _mm256_cmpeq_epi8(Chars, _mm256_set1_epi8('_')));
+  } else if constexpr (Kind == ScanKind::Digits) {
+    return inRangeAVX2(Chars, '0', '9' - '0');
+  } else {
+    return _mm256_cmpgt_epi8(Chars, _mm256_set1_epi8(-1));
+  }
+}
+
+template <ScanKind Kind>
+__attribute__((target("avx2"))) size_t scanAVX2(const char *Data,
+                                                size_t Size) {
+  constexpr uint32_t InvertMask =
+      Kind == ScanKind::NonWhitespace ? 0 : 0xFFFFFFFF;
+  size_t I = 0;
+  for (; I + 32 <= Size; I += 32) {
+    __m256i Chars =
+        _mm256_loadu_si256(reinterpret_cast<const __m256i *>(Data + I));
+    uint32_t Mismatches =
+        static_cast<uint32_t>(_mm256_movemask_epi8(matchAVX2<Kind>(Chars))) ^
+        InvertMask;
+    if (Mismatches) {
+      return I + __builtin_ctz(Mismatches);
+    }
+  }
+  return I + scanSSE2<Kind>(Data + I, Size - I);
+}
+
+__attribute__((target("avx2"))) void
+findLineStartsAVX2(const char *Data, size_t Size,
+                   std::vector<size_t> &LineStarts) {
+  const __m256i Newline = _mm256_set1_epi8('\n');
+  size_t I = 0;
+  for (; I + 32 <= Size; I += 32) {
+    __m256i Chars =
+        _mm256_loadu_si256(reinterpret_cast<const __m256i *>(Data + I));
+    for (uint32_t Mask = static_cast<uint32_t>(
+             _mm256_movemask_epi8(_mm256_cmpeq_epi8(Chars, Newline)));
+         Mask; Mask &= Mask - 1) {
+      LineStarts.push_back(I + __builtin_ctz(Mask) + 1);
+    }
+  }
+  size_t Tail = LineStarts.size();
+  findLineStartsSSE2(Data + I, Size - I, LineStarts);
+  for (; Tail < LineStarts.size(); ++Tail) {
+    LineStarts[Tail] += I;
+  }
+}
+
+#endif // COWABUNGA_X86_SIMD
+
+struct ScanKernels {
+  size_t (*Whitespace)(const char *, size_t);
+  size_t (*NonWhitespace)(const char *, size_t);
+  size_t (*Identifier)(const char *, size_t);
+  size_t (*Digits)(const char *, size_t);
+  size_t (*ASCII)(const char *, size_t);
+  void (*LineStarts)(const char *, size_t, std::vector<size_t> &);
+  const char *Kind;
+};
+
+#define COWABUNGA_SCAN_KERNELS(Scanner, LineStartsFinder, Kind)                \
+  ScanKernels {                                                                \
+    Scanner<ScanKind::Whitespace>, Scanner<ScanKind::NonWhitespace>,           \
+        Scanner<ScanKind::Identifier>, Scanner<ScanKind::Digits>,              \
+        Scanner<ScanKind::ASCII>, LineStartsFinder, Kind                       \
+  }
+
+ScanKernels selectKernels() {
+#ifdef COWABUNGA_X86_SIMD
+  __builtin_cpu_init();
+  if (__builtin_cpu_supports("avx2")) {
+    return COWABUNGA_SCAN_KERNELS(scanAVX2, findLineStartsAVX2, "avx2");
+  }
+  return COWABUNGA_SCAN_KERNELS(scanSSE2, findLineStartsSSE2, "sse2");
+#else
+  return COWABUNGA_SCAN_KERNELS(scanScalar, findLineStartsScalar, "scalar");
+#endif
+}
+
+#undef COWABUNGA_SCAN_KERNELS
+
+const ScanKernels &getKernels() {
+  static const ScanKernels Kernels = selectKernels();
+  return Kernels;
+}
+
+} // namespace
+
+size_t cb::scanWhitespace(std::string_view Text) {
+  return getKernels().Whitespace(Text.data(), Text.size());
+}
+
+size_t cb::scanNonWhitespace(std::string_view Text) {
+  return getKernels().NonWhitespace(Text.data(), Text.size());
+}
+
+size_t cb::scanIdentifierChars(std::string_view Text) {
+  return getKernels().Identifier(Text.data(), Text.size());
+}
+
+size_t cb::scanDigits(std::string_view Text) {
+  return getKernels().Digits(Text.data(), Text.size());
+}
+
+size_t cb::scanASCII(std::string_view Text) {
+  return getKernels().ASCII(Text.data(), Text.size());
+}
+
+void cb::findLineStarts(std::string_view Text,
+                        std::vector<size_t> &LineStarts) {
+  getKernels().LineStarts(Text.data(), Text.size(), LineStarts);
+}
+
+bool cb::isIdentifierStart(char Char) {
+  return CharClasses[static_cast<unsigned char>(Char)] & CC_IdentifierStart;
+}
+
+const char *cb::getCharScannersKind() { return getKernels().Kind; }
@@ -1,5 +1,27 @@
 #include "cowabunga/Lexer/ITokenizer.h"
 
+#include "cowabunga/Lexer/Token.h"
+
+#include <cassert>
+
 using namespace cb;
 
+size_t ITokenizer::matchLength(std::string_view Word) {
+  auto [FoundToken, TokenLength] = tokenize(Word);
+  return FoundToken ? TokenLength : 0;
+}
+
+Token ITokenizer::buildToken(std::string_view Lexeme) {
+  auto [FoundToken, TokenLength] = tokenize(Lexeme);
+  assert(FoundToken && TokenLength == Lexeme.length() &&
+         "Lexeme should be accepted by matchLength");
+  return *FoundToken;
+}
+
+std::vector<std::pair<int, std::string>> ITokenizer::getLexemeStrings() const {
+  return {std::make_pair(getTokenID(), getLexemeString())};
+}
+
+std::vector<TokenPattern> ITokenizer::getPatterns() const { return {}; }
+
 ITokenizer::~ITokenizer() {}
@@ -0,0 +1,29 @@
+#include "cowabunga/Lexer/LexemeTable.h"
+
+#include <cassert>
+#include <stdexcept>
+
+using namespace cb;
+
+void LexemeTable::set(int TokenID, std::string Lexeme) {
+  assert(TokenID >= 0 && "Token ID should be non-negative");
+  size_t Index = static_cast<size_t>(TokenID);
+  if (Index >= Lexemes.size()) {
+    Lexemes.resize(Index + 1);
+    Present.resize(Index + 1, false);
+  }
+  Lexemes[Index] = std::move(Lexeme);
+  Present[Index] = true;
+}
+
+bool LexemeTable::contains(int TokenID) const noexcept {
+  return TokenID >= 0 && static_cast<size_t>(TokenID) < Present.size() &&
+         Present[TokenID];
+}
+
+std::string_view LexemeTable::get(int TokenID) const {
+  if (!contains(TokenID)) {
+    throw std::out_of_range("Token ID has no lexeme");
+  }
+  return Lexemes[TokenID];
+}
@@ -1,57 +1,51 @@
 #include "cowabunga/Lexer/Lexer.h"
 
+#include "LineTokenizer.h"
+#include "cowabunga/Common/ThreadPool.h"
+#include "cowabunga/Lexer/LexerDiagnostics.h"
 #include "cowabunga/Lexer/Token.h"
+#include "cowabunga/Lexer/Unicode.h"
 
+#include <algorithm>
 #include <cassert>
-#include <cctype>
+#include <cstdint>
 #include <iostream>
+#include <limits>
 #include <optional>
+#include <sstream>
+#include <thread>
 
 using namespace cb;
 
 namespace {
 
-class LineTokenizer final {
-public:
-  LineTokenizer(std::vector<std::unique_ptr<ITokenizerProxy>> &TokenizersRef,
-                std::string FileName);
+/// Sources are split into chunks of at least this size, smaller ones aren't
+/// worth handing to another thread.
+constexpr size_t MinParallelChunkSize = 1 << 20;
 
-  std::vector<Token> tokenize(const std::string &LineArg);
-
-  int getError() const noexcept;
-
-  operator bool() const noexcept;
-
-private:
-  void skipWhitespace();
-
-  void findBestToken();
-
-  void removeNonWhitespaceRange();
-
-  void fillBestTokenMetadata();
-
-  void raiseErrorOnUnrecognizedToken();
-
-  std::vector<std::unique_ptr<ITokenizerProxy>> &Tokenizers;
-  std::shared_ptr<const std::string> File;
-  std::shared_ptr<const std::string> SharedLine;
-  std::string_view Line;
-  std::optional<Token> BestToken;
-  size_t BestTokenLength;
-  size_t LineNumber;
-  size_t Position;
-  int Error;
-};
+/// Returns offsets [0, B1, ..., Text.length()] which split Text into at most
+/// ChunksNumber chunks of whole lines of about equal size.
+std::vector<size_t> splitIntoLineChunks(std::string_view Text,
+                                        size_t ChunksNumber) {
+  std::vector<size_t> Bounds{0};
+  for (size_t I = 1; I < ChunksNumber; ++I) {
+    size_t ChunkEnd = Text.find(
+        '\n', std::max(Bounds.back(), Text.length() / ChunksNumber * I));
+    if (ChunkEnd == std::string_view::npos ||
+        ChunkEnd + 1 == Text.length()) {
+      break;
+    }
+    Bounds.push_back(ChunkEnd + 1);
+  }
+  Bounds.push_back(Text.length());
+  return Bounds;
+}
 
 } // namespace
 
-Lexer::Lexer(const Lexer &RHS) {
-  Tokenizers.reserve(RHS.Tokenizers.size());
-  for (auto &Tokenizer : RHS.Tokenizers) {
-    Tokenizers.push_back(Tokenizer->clone());
-  }
-}
+Lexer::Lexer(const Lexer &RHS)
+    : Lexemes(RHS.Lexemes), Tokenizers(RHS.cloneTokenizers()), DFA(RHS.DFA),
+      Sources(RHS.Sources) {}
 
 Lexer &Lexer::operator=(const Lexer &RHS) {
   Lexer NewLexer(RHS);
@@ -61,117 +55,218 @@ Lexer &Lexer::operator=(const Lexer &RHS) {
 
 std::vector<Token> Lexer::tokenize(std::istream &Input,
                                    const std::string &FileName) {
+  return tokenize(SourceBuffer::fromStream(Input, FileName));
+}
+
+std::vector<Token>
+Lexer::tokenize(std::shared_ptr<const SourceBuffer> Source) {
+  uint32_t FileIndex = addSource(Source);
   std::vector<Token> Tokens;
-  std::string Line;
-  LineTokenizer Tokenizer(Tokenizers, FileName);
-  while (std::getline(Input, Line)) {
-    auto NewTokens = Tokenizer.tokenize(Line);
-    std::move(NewTokens.begin(), NewTokens.end(), std::back_inserter(Tokens));
+  LineTokenizer Tokenizer(Tokenizers, DFA.get(), *Source, FileIndex);
+  while (auto Tok = Tokenizer.next()) {
+    Tokens.push_back(*Tok);
   }
   if (!Tokenizer) {
-    std::cerr << "Failed to parse " << FileName << std::endl;
+    std::cerr << "Failed to parse " << Source->getName() << std::endl;
     exit(1);
   }
   return Tokens;
 }
 
-std::string Lexer::getTokenLexeme(int ID) const {
-  return LexemeStringMapping.at(ID);
-}
+std::vector<Token>
+Lexer::tokenizeParallel(std::shared_ptr<const SourceBuffer> Source,
+                        unsigned ThreadsNumber) {
+  assert(Source && "Source shouldn't be nullptr");
+  if (ThreadsNumber == 0) {
+    ThreadsNumber = std::max(1U, std::thread::hardware_concurrency());
+  }
+  size_t ChunksNumber = std::min<size_t>(
+      ThreadsNumber, Source->getText().length() / MinParallelChunkSize);
+  if (ChunksNumber <= 1) {
+    return tokenize(std::move(Source));
+  }
+  uint32_t FileIndex = addSource(Source);
+  auto Bounds = splitIntoLineChunks(Source->getText(), ChunksNumber);
+  ChunksNumber = Bounds.size() - 1;
 
-LineTokenizer::LineTokenizer(
-    std::vector<std::unique_ptr<ITokenizerProxy>> &TokenizersRef,
-    std::string FileName)
-    : Tokenizers(TokenizersRef),
-      File(std::make_shared<const std::string>(std::move(FileName))),
-      LineNumber(0), Position(0), Error(0) {}
-
-std::vector<Token> LineTokenizer::tokenize(const std::string &LineArg) {
-  SharedLine = std::make_shared<const std::string>(LineArg);
-  Line = LineArg;
-  ++LineNumber;
-  Position = 0;
-  std::vector<Token> Tokens;
-  skipWhitespace();
-  while (Position != LineArg.length()) {
-    findBestToken();
-    if (!BestToken) {
-      raiseErrorOnUnrecognizedToken();
-      removeNonWhitespaceRange();
-    } else {
-      Line.remove_prefix(BestTokenLength);
-      fillBestTokenMetadata();
-      Position += BestTokenLength;
-      Tokens.push_back(std::move(*BestToken));
+  std::vector<std::vector<Token>> ChunkTokens(ChunksNumber);
+  std::vector<std::ostringstream> ChunkErrors(ChunksNumber);
+  std::vector<char> ChunkFailed(ChunksNumber, false);
+  // Chunk 0 is lexed by the tokenizers of this Lexer, other chunks by their
+  // own copies, as tokenizers aren't thread-safe.
+  auto TokenizeChunk = [&](size_t Chunk) {
+    std::vector<std::unique_ptr<ITokenizerProxy>> ChunkTokenizers;
+    if (Chunk != 0) {
+      ChunkTokenizers = cloneTokenizers();
+    }
+    LineTokenizer Tokenizer(Chunk == 0 ? Tokenizers : ChunkTokenizers,
+                            DFA.get(), *Source, FileIndex, Bounds[Chunk],
+                            Bounds[Chunk + 1], ChunkErrors[Chunk]);
+    while (auto Tok = Tokenizer.next()) {
+      ChunkTokens[Chunk].push_back(*Tok);
     }
-    skipWhitespace();
+    ChunkFailed[Chunk] = !Tokenizer;
+  };
+  ThreadPool::getShared().run(ChunksNumber, ThreadsNumber, TokenizeChunk);
+
+  for (auto &Errors : ChunkErrors) {
+    std::cerr << Errors.str();
+  }
+  if (std::find(ChunkFailed.begin(), ChunkFailed.end(), true) !=
+      ChunkFailed.end()) {
+    std::cerr << "Failed to parse " << Source->getName() << std::endl;
+    exit(1);
+  }
+  size_t TokensNumber = 0;
+  for (auto &Chunk : ChunkTokens) {
+    TokensNumber += Chunk.size();
+  }
+  std::vector<Token> Tokens;
+  Tokens.reserve(TokensNumber);
+  for (auto &Chunk : ChunkTokens) {
+    Tokens.insert(Tokens.end(), Chunk.begin(), Chunk.end());
   }
   return Tokens;
 }
 
-void LineTokenizer::skipWhitespace() {
-  size_t WhitespacePrefixLength = Line.find_first_not_of(" \t");
-  if (WhitespacePrefixLength != std::string_view::npos) {
-    Line.remove_prefix(WhitespacePrefixLength);
-    Position += WhitespacePrefixLength;
+TokenRangeChange Lexer::retokenize(std::vector<Token> &Tokens,
+                                  uint32_t FileIndex, const SourceEdit &Edit) {
+  auto OldSource = Sources.getBufferPtr(FileIndex);
+  auto OldText = OldSource->getText();
+  assert(Edit.Offset + Edit.Length <= OldText.length() &&
+         "Edit is out of source");
+  size_t EditEnd = Edit.Offset + Edit.Length;
+  // Tokens don't span lines, so only lines from the one containing the
+  // beginning of the edit to the one containing its end are lexed again.
+  // Lines are found by scanning, the line table of the source would be built
+  // over the whole file for every edit.
+  size_t RelexBegin =
+      Edit.Offset == 0 ? 0 : OldText.rfind('\n', Edit.Offset - 1) + 1;
+  size_t RelexEnd = OldText.find('\n', EditEnd);
+  RelexEnd = RelexEnd == std::string_view::npos ? OldText.length()
+                                                : RelexEnd + 1;
+
+  std::string NewText;
+  NewText.reserve(OldText.length() - Edit.Length + Edit.Replacement.length());
+  NewText.append(OldText.substr(0, Edit.Offset))
+      .append(Edit.Replacement)
+      .append(OldText.substr(EditEnd));
+  if (NewText.length() > std::numeric_limits<uint32_t>::max()) {
+    std::cerr << OldSource->getName() << ": file is too large" << std::endl;
+    exit(1);
+  }
+  auto NewSource =
+      SourceBuffer::fromString(std::move(NewText), OldSource->getName());
+  int64_t Shift = static_cast<int64_t>(Edit.Replacement.length()) -
+                  static_cast<int64_t>(Edit.Length);
+
+  // UTF-8 sequences never contain '\n', so only relexed lines may have become
+  // invalid.
+  auto RelexedText =
+      NewSource->getText().substr(RelexBegin, RelexEnd + Shift - RelexBegin);
+  size_t ValidLength = scanValidUTF8(RelexedText);
+  if (ValidLength != RelexedText.length()) {
+    auto &Lines = NewSource->getLineTable();
+    std::cerr << NewSource->getName() << ":"
+              << Lines.getLineNumber(RelexBegin + ValidLength) << ":"
+              << Lines.getColumnNumber(RelexBegin + ValidLength)
+              << ": invalid UTF-8" << std::endl;
+    std::cerr << "Failed to parse " << NewSource->getName() << std::endl;
+    exit(1);
+  }
+
+  std::vector<Token> RelexedTokens;
+  LineTokenizer Tokenizer(Tokenizers, DFA.get(), *NewSource, FileIndex,
+                          RelexBegin, RelexEnd + Shift, std::cerr);
+  while (auto Tok = Tokenizer.next()) {
+    RelexedTokens.push_back(*Tok);
+  }
+  if (!Tokenizer) {
+    std::cerr << "Failed to parse " << NewSource->getName() << std::endl;
+    exit(1);
+  }
+  Sources.replaceBuffer(FileIndex, std::move(NewSource));
+
+  auto ByOffset = [](const Token &Tok, size_t Offset) {
+    return Tok.Offset < Offset;
+  };
+  auto OldBegin =
+      std::lower_bound(Tokens.begin(), Tokens.end(), RelexBegin, ByOffset);
+  auto OldEnd = std::lower_bound(OldBegin, Tokens.end(), RelexEnd, ByOffset);
+  for (auto It = OldEnd; It != Tokens.end(); ++It) {
+    It->Offset = static_cast<uint32_t>(It->Offset + Shift);
+  }
+  TokenRangeChange Change;
+  Change.Begin = OldBegin - Tokens.begin();
+  Change.OldEnd = OldEnd - Tokens.begin();
+  Change.NewEnd = Change.Begin + RelexedTokens.size();
+  // Reuse slots of the replaced tokens and only move the tail when the
+  // number of tokens changes.
+  size_t Common = std::min(RelexedTokens.size(), Change.OldEnd - Change.Begin);
+  std::copy_n(RelexedTokens.begin(), Common, OldBegin);
+  if (RelexedTokens.size() > Common) {
+    Tokens.insert(OldBegin + Common, RelexedTokens.begin() + Common,
+                  RelexedTokens.end());
   } else {
-    Position += Line.length();
+    Tokens.erase(OldBegin + Common, OldEnd);
   }
+  return Change;
 }
 
-void LineTokenizer::removeNonWhitespaceRange() {
-  size_t NonWhitespaceLength = Line.find_first_of(" \t");
-  if (NonWhitespaceLength == std::string_view::npos) {
-    NonWhitespaceLength = Line.length();
+std::optional<std::vector<Token>>
+Lexer::tokenizeFile(const std::string &Path) {
+  auto Source = SourceBuffer::fromFile(Path);
+  if (!Source) {
+    return std::nullopt;
   }
-  Line.remove_prefix(NonWhitespaceLength);
-  Position += NonWhitespaceLength;
+  return tokenize(std::move(Source));
 }
 
-void LineTokenizer::findBestToken() {
-  std::optional<Token> BestFoundToken;
-  size_t BestFoundTokenLength = 0;
+TokenStream Lexer::stream(std::shared_ptr<const SourceBuffer> Source,
+                          size_t LookaheadLimit) {
+  uint32_t FileIndex = addSource(Source);
+  return TokenStream(std::make_unique<LineTokenizer>(Tokenizers, DFA.get(),
+                                                     *Source, FileIndex),
+                     LookaheadLimit);
+}
+
+bool Lexer::compile() {
+  std::vector<TokenPattern> Patterns;
   for (auto &Tokenizer : Tokenizers) {
-    auto [FoundToken, TokenLength] = Tokenizer->tokenize(Line);
-    if (BestFoundToken < FoundToken) {
-      BestFoundToken = FoundToken;
-      BestFoundTokenLength = TokenLength;
+    auto TokenizerPatterns = Tokenizer->getPatterns();
+    if (TokenizerPatterns.empty()) {
+      return false;
     }
+    std::move(TokenizerPatterns.begin(), TokenizerPatterns.end(),
+              std::back_inserter(Patterns));
   }
-  BestToken = BestFoundToken;
-  BestTokenLength = BestFoundTokenLength;
+  DFA = std::make_shared<const TokenDFA>(Patterns);
+  return true;
 }
 
-void LineTokenizer::raiseErrorOnUnrecognizedToken() {
-  assert(SharedLine && "SharedLine shouldn't be nullptr");
-  assert(Position < SharedLine->length() &&
-         "Position should be less than line's length");
-  std::cerr << *File << ":" << LineNumber << ":" << Position + 1
-            << ": unrecognized lexeme\n";
-  std::cerr << "\t" << *SharedLine << "\n\t";
-  for (size_t I = 0; I < Position; ++I) {
-    std::cerr << " ";
-  }
-  std::cerr << "^";
-  for (auto *It = Line.cbegin() + 1, *ItEnd = Line.cend();
-       It != ItEnd && !std::isspace(*It); ++It) {
-    std::cerr << "~";
-  }
-  std::cerr << "\n";
-  Error = 1;
+bool Lexer::isCompiled() const noexcept { return DFA != nullptr; }
+
+std::string_view Lexer::getTokenLexeme(int ID) const {
+  return Lexemes.get(ID);
 }
 
-void LineTokenizer::fillBestTokenMetadata() {
-  assert(
-      BestToken.has_value() &&
-      "LineTokenizer's BestToken member is nullopt, but has to contain value");
-  BestToken->Line = SharedLine;
-  BestToken->BeginColumnNumber = Position + 1;
-  BestToken->EndColumnNumber = Position + 1 + BestTokenLength;
-  BestToken->LineNumber = LineNumber;
-  BestToken->File = File;
+const SourceManager &Lexer::getSourceManager() const noexcept {
+  return Sources;
 }
 
-int LineTokenizer::getError() const noexcept { return Error; }
+std::vector<std::unique_ptr<ITokenizerProxy>> Lexer::cloneTokenizers() const {
+  std::vector<std::unique_ptr<ITokenizerProxy>> Clones;
+  Clones.reserve(Tokenizers.size());
+  for (auto &Tokenizer : Tokenizers) {
+    Clones.push_back(Tokenizer->clone());
+  }
+  return Clones;
+}
 
-LineTokenizer::operator bool() const noexcept { return Error == 0; }
+uint32_t Lexer::addSource(std::shared_ptr<const SourceBuffer> Source) {
+  assert(Source && "Source shouldn't be nullptr");
+  if (!checkSource(std::cerr, *Source)) {
+    exit(1);
+  }
+  return Sources.addBuffer(std::move(Source));
+}
@@ -0,0 +1,54 @@
+#include "cowabunga/Lexer/LexerDiagnostics.h"
+
+#include "cowabunga/Lexer/Unicode.h"
+
+#include <cassert>
+#include <cctype>
+#include <cstdint>
+#include <limits>
+
+using namespace cb;
+
+void cb::reportUnrecognizedLexeme(std::ostream &Errors,
+                                  const SourceBuffer &Source,
+                                  size_t LineOffset, std::string_view Line,
+                                  size_t Position) {
+  assert(Position < Line.length() &&
+         "Position should be less than line's length");
+  Errors << Source.getName() << ":" << Source.getLineNumber(LineOffset) << ":"
+         << Position + 1 << ": unrecognized lexeme\n";
+  Errors << "\t" << Line << "\n\t";
+  for (size_t I = 0; I < Position; ++I) {
+    Errors << " ";
+  }
+  Errors << "^";
+  for (auto *It = Line.cbegin() + Position + 1, *ItEnd = Line.cend();
+       It != ItEnd && !std::isspace(static_cast<unsigned char>(*It)); ++It) {
+    Errors << "~";
+  }
+  Errors << "\n";
+}
+
+bool cb::checkUTF8(std::ostream &Errors, const SourceBuffer &Source) {
+  auto Text = Source.getText();
+  size_t ValidLength = scanValidUTF8(Text);
+  if (ValidLength == Text.length()) {
+    return true;
+  }
+  auto &Lines = Source.getLineTable();
+  Errors << Source.getName() << ":" << Lines.getLineNumber(ValidLength) << ":"
+         << Lines.getColumnNumber(ValidLength) << ": invalid UTF-8\n";
+  return false;
+}
+
+bool cb::checkSource(std::ostream &Errors, const SourceBuffer &Source) {
+  if (Source.getText().length() > std::numeric_limits<uint32_t>::max()) {
+    Errors << Source.getName() << ": file is too large\n";
+    return false;
+  }
+  if (!checkUTF8(Errors, Source)) {
+    Errors << "Failed to parse " << Source.getName() << "\n";
+    return false;
+  }
+  return true;
+}
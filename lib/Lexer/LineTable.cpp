@@ -0,0 +1,39 @@
+#include "cowabunga/Lexer/LineTable.h"
+
+#include "cowabunga/Lexer/CharScanners.h"
+
+#include <algorithm>
+#include <cassert>
+
+using namespace cb;
+
+LineTable::LineTable(std::string_view SourceText) : Text(SourceText) {
+  LineOffsets.push_back(0);
+  findLineStarts(Text, LineOffsets);
+}
+
+size_t LineTable::getLineNumber(size_t Offset) const {
+  assert(Offset <= Text.length() && "Offset is out of text");
+  return std::upper_bound(LineOffsets.begin(), LineOffsets.end(), Offset) -
+         LineOffsets.begin();
+}
+
+size_t LineTable::getColumnNumber(size_t Offset) const {
+  return Offset - getLineOffset(Offset) + 1;
+}
+
+size_t LineTable::getLineOffset(size_t Offset) const {
+  return LineOffsets[getLineNumber(Offset) - 1];
+}
+
+std::string_view LineTable::getLine(size_t Offset) const {
+  size_t LineNumber = getLineNumber(Offset);
+  size_t LineBegin = LineOffsets[LineNumber - 1];
+  size_t LineEnd = LineNumber < LineOffsets.size() ? LineOffsets[LineNumber] - 1
+                                                   : Text.length();
+  return Text.substr(LineBegin, LineEnd - LineBegin);
+}
+
+size_t LineTable::getLinesNumber() const noexcept {
+  return LineOffsets.size();
+}
@@ -0,0 +1,65 @@
+#include "LineTokenizer.h"
+
+using namespace cb;
+
+namespace {
+
+bool isNonASCIIAt(std::string_view Line, size_t Position) {
+  return Position < Line.length() &&
+         static_cast<unsigned char>(Line[Position]) >= 0x80;
+}
+
+} // namespace
+
+TokenizerMatcher::TokenizerMatcher(
+    std::vector<std::unique_ptr<ITokenizerProxy>> &TokenizersRef,
+    const TokenDFA *CompiledTokenizers)
+    : Tokenizers(&TokenizersRef), DFA(CompiledTokenizers) {}
+
+std::pair<std::optional<Token>, size_t>
+TokenizerMatcher::operator()(std::string_view Line) {
+  // Patterns describe tokens on ASCII input only, so tokenizers are asked
+  // directly when a token starts or may continue with a non-ASCII character.
+  if (DFA && !isNonASCIIAt(Line, 0)) {
+    auto [TokenID, TokenLength] = DFA->match(Line);
+    if (!isNonASCIIAt(Line, TokenLength)) {
+      std::optional<Token> BestToken;
+      if (TokenLength) {
+        BestToken = Token(TokenID);
+      }
+      return std::make_pair(BestToken, TokenLength);
+    }
+  }
+  std::optional<Token> BestToken;
+  size_t BestTokenLength = 0;
+  for (auto &Tokenizer : *Tokenizers) {
+    size_t TokenLength = Tokenizer->matchLength(Line);
+    if (!TokenLength) {
+      continue;
+    }
+    auto FoundToken = Tokenizer->buildToken(Line.substr(0, TokenLength));
+    if (!BestToken || BestToken->getID() < FoundToken.getID() ||
+        (BestToken->getID() == FoundToken.getID() &&
+         BestTokenLength < TokenLength)) {
+      BestToken = FoundToken;
+      BestTokenLength = TokenLength;
+    }
+  }
+  return std::make_pair(BestToken, BestTokenLength);
+}
+
+LineTokenizer::LineTokenizer(
+    std::vector<std::unique_ptr<ITokenizerProxy>> &TokenizersRef,
+    const TokenDFA *CompiledTokenizers, const SourceBuffer &SourceRef,
+    uint32_t SourceFileIndex)
+    : BasicLineTokenizer(TokenizerMatcher(TokenizersRef, CompiledTokenizers),
+                         SourceRef, SourceFileIndex) {}
+
+LineTokenizer::LineTokenizer(
+    std::vector<std::unique_ptr<ITokenizerProxy>> &TokenizersRef,
+    const TokenDFA *CompiledTokenizers, const SourceBuffer &SourceRef,
+    uint32_t SourceFileIndex, size_t RangeBegin, size_t RangeEnd,
+    std::ostream &Diagnostics)
+    : BasicLineTokenizer(TokenizerMatcher(TokenizersRef, CompiledTokenizers),
+                         SourceRef, SourceFileIndex, RangeBegin, RangeEnd,
+                         Diagnostics) {}
@@ -0,0 +1,51 @@
+#ifndef COWABUNGA_LIB_LEXER_LINETOKENIZER_H
+#define COWABUNGA_LIB_LEXER_LINETOKENIZER_H
+
+#include "cowabunga/Lexer/BasicLineTokenizer.h"
+#include "cowabunga/Lexer/SourceBuffer.h"
+#include "cowabunga/Lexer/Token.h"
+#include "cowabunga/Lexer/TokenDFA.h"
+#include "cowabunga/Lexer/TokenizerProxy.h"
+
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <ostream>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+namespace cb {
+
+/// TokenizerMatcher picks the best match of Lexer's tokenizers, using their
+/// TokenDFA when it is compiled.
+class TokenizerMatcher final {
+public:
+  TokenizerMatcher(std::vector<std::unique_ptr<ITokenizerProxy>> &TokenizersRef,
+                   const TokenDFA *CompiledTokenizers);
+
+  std::pair<std::optional<Token>, size_t> operator()(std::string_view Line);
+
+private:
+  std::vector<std::unique_ptr<ITokenizerProxy>> *Tokenizers;
+  const TokenDFA *DFA;
+};
+
+/// LineTokenizer tokenizes a source with tokenizers of Lexer.
+class LineTokenizer final : public BasicLineTokenizer<TokenizerMatcher> {
+public:
+  LineTokenizer(std::vector<std::unique_ptr<ITokenizerProxy>> &TokenizersRef,
+                const TokenDFA *CompiledTokenizers,
+                const SourceBuffer &SourceRef, uint32_t SourceFileIndex);
+
+  /// See BasicLineTokenizer for the meaning of the range.
+  LineTokenizer(std::vector<std::unique_ptr<ITokenizerProxy>> &TokenizersRef,
+                const TokenDFA *CompiledTokenizers,
+                const SourceBuffer &SourceRef, uint32_t SourceFileIndex,
+                size_t RangeBegin, size_t RangeEnd,
+                std::ostream &Diagnostics);
+};
+
+} // namespace cb
+
+#endif // COWABUNGA_LIB_LEXER_LINETOKENIZER_H
@@ -0,0 +1,104 @@
+#include "cowabunga/Lexer/SourceBuffer.h"
+
+#include <cassert>
+#include <fstream>
+#include <iterator>
+#include <sstream>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#define COWABUNGA_HAS_MMAP 1
+#endif
+
+using namespace cb;
+
+SourceBuffer::SourceBuffer(std::string Name)
+    : BufferName(std::move(Name)), Data(nullptr), Size(0), Mapped(false) {}
+
+std::shared_ptr<const SourceBuffer>
+SourceBuffer::fromFile(const std::string &Path) {
+#ifdef COWABUNGA_HAS_MMAP
+  int FD = open(Path.c_str(), O_RDONLY);
+  if (FD < 0) {
+    return nullptr;
+  }
+  struct stat FileStat;
+  if (fstat(FD, &FileStat) == 0 && S_ISREG(FileStat.st_mode) &&
+      FileStat.st_size > 0) {
+    size_t FileSize = static_cast<size_t>(FileStat.st_size);
+    void *Mapping = mmap(nullptr, FileSize, PROT_READ, MAP_PRIVATE, FD, 0);
+    if (Mapping != MAP_FAILED) {
+      close(FD);
+      madvise(Mapping, FileSize, MADV_SEQUENTIAL);
+      std::shared_ptr<SourceBuffer> Buffer(new SourceBuffer(Path));
+      Buffer->Data = static_cast<const char *>(Mapping);
+      Buffer->Size = FileSize;
+      Buffer->Mapped = true;
+      return Buffer;
+    }
+  }
+  close(FD);
+#endif
+  std::ifstream Input(Path, std::ios::binary);
+  if (!Input) {
+    return nullptr;
+  }
+  return fromStream(Input, Path);
+}
+
+std::shared_ptr<const SourceBuffer>
+SourceBuffer::fromStream(std::istream &Input, std::string Name) {
+  std::ostringstream Text;
+  Text << Input.rdbuf();
+  return fromString(Text.str(), std::move(Name));
+}
+
+std::shared_ptr<const SourceBuffer>
+SourceBuffer::fromString(std::string Text, std::string Name) {
+  std::shared_ptr<SourceBuffer> Buffer(new SourceBuffer(std::move(Name)));
+  Buffer->Storage = std::move(Text);
+  Buffer->Data = Buffer->Storage.data();
+  Buffer->Size = Buffer->Storage.size();
+  return Buffer;
+}
+
+SourceBuffer::~SourceBuffer() {
+#ifdef COWABUNGA_HAS_MMAP
+  if (Mapped) {
+    munmap(const_cast<char *>(Data), Size);
+  }
+#endif
+}
+
+std::string_view SourceBuffer::getText() const noexcept {
+  return std::string_view(Data, Size);
+}
+
+std::string_view SourceBuffer::getLine(size_t LineOffset) const {
+  assert(LineOffset <= Size && "LineOffset is out of buffer");
+  auto Line = getText().substr(LineOffset);
+  return Line.substr(0, Line.find('\n'));
+}
+
+const LineTable &SourceBuffer::getLineTable() const {
+  std::call_once(LinesIndexed,
+                 [this] { Lines = std::make_unique<LineTable>(getText()); });
+  return *Lines;
+}
+
+size_t SourceBuffer::getLineNumber(size_t Offset) const {
+  return getLineTable().getLineNumber(Offset);
+}
+
+size_t SourceBuffer::getLineOffset(size_t Offset) const {
+  return getLineTable().getLineOffset(Offset);
+}
+
+const std::string &SourceBuffer::getName() const noexcept {
+  return BufferName;
+}
+
+bool SourceBuffer::isMapped() const noexcept { return Mapped; }
@@ -0,0 +1,59 @@
+#include "cowabunga/Lexer/SourceManager.h"
+
+#include <cassert>
+#include <limits>
+
+using namespace cb;
+
+uint32_t SourceManager::addBuffer(std::shared_ptr<const SourceBuffer> Buffer) {
+  assert(Buffer && "Buffer shouldn't be nullptr");
+  assert(Buffers.size() < std::numeric_limits<uint32_t>::max() &&
+         "Too many buffers");
+  Buffers.push_back(std::move(Buffer));
+  return static_cast<uint32_t>(Buffers.size() - 1);
+}
+
+const SourceBuffer &SourceManager::getBuffer(uint32_t FileIndex) const {
+  assert(FileIndex < Buffers.size() && "Unknown FileIndex");
+  return *Buffers[FileIndex];
+}
+
+void SourceManager::replaceBuffer(uint32_t FileIndex,
+                                  std::shared_ptr<const SourceBuffer> Buffer) {
+  assert(Buffer && "Buffer shouldn't be nullptr");
+  assert(FileIndex < Buffers.size() && "Unknown FileIndex");
+  Buffers[FileIndex] = std::move(Buffer);
+}
+
+std::shared_ptr<const SourceBuffer>
+SourceManager::getBufferPtr(uint32_t FileIndex) const {
+  assert(FileIndex < Buffers.size() && "Unknown FileIndex");
+  return Buffers[FileIndex];
+}
+
+const std::string &SourceManager::getFile(const Token &Tok) const {
+  return getBuffer(Tok.FileIndex).getName();
+}
+
+std::string_view SourceManager::getLine(const Token &Tok) const {
+  return getBuffer(Tok.FileIndex).getLineTable().getLine(Tok.Offset);
+}
+
+std::string_view SourceManager::getLexeme(const Token &Tok) const {
+  return getBuffer(Tok.FileIndex).getText().substr(Tok.Offset, Tok.Length);
+}
+
+size_t SourceManager::getLineNumber(const Token &Tok) const {
+  return getBuffer(Tok.FileIndex).getLineTable().getLineNumber(Tok.Offset);
+}
+
+size_t SourceManager::getColumnNumber(const Token &Tok) const {
+  return getBuffer(Tok.FileIndex).getLineTable().getColumnNumber(Tok.Offset);
+}
+
+void SourceManager::print(std::ostream &Out, const Token &Tok) const {
+  auto ColumnNumber = getColumnNumber(Tok);
+  Out << "'" << getLexeme(Tok) << "' <line: " << getLineNumber(Tok)
+      << ", col: " << ColumnNumber << ":" << ColumnNumber + Tok.Length - 1
+      << ">";
+}
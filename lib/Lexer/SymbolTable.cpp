@@ -0,0 +1,35 @@
+#include "cowabunga/Lexer/SymbolTable.h"
+
+#include <cassert>
+#include <limits>
+
+using namespace cb;
+
+SymbolTable::ID SymbolTable::intern(std::string_view Name) {
+  auto It = IDs.find(Name);
+  if (It != IDs.end()) {
+    return It->second;
+  }
+  assert(Names.size() < std::numeric_limits<ID>::max() && "Too many symbols");
+  auto NewID = static_cast<ID>(Names.size());
+  // Deque never relocates its elements, so keys keep pointing to them.
+  Names.emplace_back(Name);
+  IDs.emplace(Names.back(), NewID);
+  return NewID;
+}
+
+std::optional<SymbolTable::ID>
+SymbolTable::lookup(std::string_view Name) const {
+  auto It = IDs.find(Name);
+  if (It == IDs.end()) {
+    return std::nullopt;
+  }
+  return It->second;
+}
+
+std::string_view SymbolTable::getName(ID SymbolID) const {
+  assert(SymbolID < Names.size() && "Unknown symbol");
+  return Names[SymbolID];
+}
+
+size_t SymbolTable::size() const noexcept { return Names.size(); }
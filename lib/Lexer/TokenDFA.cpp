@@ -0,0 +1,228 @@
+#include "cowabunga/Lexer/TokenDFA.h"
+
+#include <algorithm>
+#include <cassert>
+#include <map>
+#include <tuple>
+
+using namespace cb;
+
+namespace {
+
+/// Each NFA item is a position inside one of the patterns. Position equal to
+/// the number of pattern elements means that the pattern is matched.
+class PatternItems final {
+public:
+  PatternItems(const std::vector<TokenPattern> &PatternsRef);
+
+  std::vector<size_t> getStartItems() const;
+
+  std::vector<size_t> step(const std::vector<size_t> &Items,
+                           unsigned char Char) const;
+
+  const TokenPattern *getAcceptedPattern(size_t Item) const;
+
+private:
+  void addClosure(size_t Item, std::vector<size_t> &Items) const;
+
+  const std::vector<TokenPattern> &Patterns;
+  std::vector<size_t> Offsets;
+  std::vector<size_t> ItemPatterns;
+};
+
+} // namespace
+
+TokenDFA::TokenDFA(const std::vector<TokenPattern> &Patterns) {
+  buildCharClasses(Patterns);
+  buildStates(Patterns);
+  minimize();
+}
+
+std::pair<int, size_t> TokenDFA::match(std::string_view Word) const {
+  uint32_t State = StartState;
+  int BestID = 0;
+  int BestPriority = 0;
+  size_t BestLength = 0;
+  const char *Data = Word.data();
+  for (size_t I = 0, E = Word.size(); I < E; ++I) {
+    State = Transitions[State * CharClassesNumber +
+                        CharClasses[static_cast<unsigned char>(Data[I])]];
+    if (State == DeadState) {
+      break;
+    }
+    const AcceptInfo &Accept = Accepts[State];
+    if (Accept.Accepting && (!BestLength || Accept.Priority >= BestPriority)) {
+      BestID = Accept.TokenID;
+      BestPriority = Accept.Priority;
+      BestLength = I + 1;
+    }
+  }
+  return std::make_pair(BestID, BestLength);
+}
+
+size_t TokenDFA::getStatesNumber() const noexcept { return Accepts.size(); }
+
+void TokenDFA::buildCharClasses(const std::vector<TokenPattern> &Patterns) {
+  std::array<size_t, 256> Classes{};
+  size_t ClassesNumber = 1;
+  for (auto &Pattern : Patterns) {
+    for (auto &Element : Pattern.getElements()) {
+      std::map<std::pair<size_t, bool>, size_t> Split;
+      for (unsigned Char = 0; Char < 256; ++Char) {
+        auto Key = std::make_pair(Classes[Char], Element.Chars.contains(Char));
+        Classes[Char] = Split.emplace(Key, Split.size()).first->second;
+      }
+      ClassesNumber = Split.size();
+    }
+  }
+  assert(ClassesNumber <= 256 && "There can't be more classes than bytes");
+  CharClassesNumber = ClassesNumber;
+  for (unsigned Char = 0; Char < 256; ++Char) {
+    CharClasses[Char] = static_cast<uint8_t>(Classes[Char]);
+  }
+}
+
+void TokenDFA::buildStates(const std::vector<TokenPattern> &Patterns) {
+  PatternItems Items(Patterns);
+  std::array<unsigned char, 256> Representatives{};
+  for (unsigned Char = 256; Char-- > 0;) {
+    Representatives[CharClasses[Char]] = static_cast<unsigned char>(Char);
+  }
+  std::vector<std::vector<size_t>> States;
+  std::map<std::vector<size_t>, uint32_t> StateIDs;
+  States.emplace_back();
+  StateIDs.emplace(States.back(), DeadState);
+  auto StartItems = Items.getStartItems();
+  StartState = StateIDs.emplace(StartItems, States.size()).first->second;
+  States.push_back(std::move(StartItems));
+  for (size_t State = 0; State < States.size(); ++State) {
+    auto StateItems = States[State];
+    Transitions.resize((State + 1) * CharClassesNumber, DeadState);
+    for (size_t Class = 0; Class < CharClassesNumber; ++Class) {
+      auto NextItems = Items.step(StateItems, Representatives[Class]);
+      auto [It, Inserted] = StateIDs.emplace(NextItems, States.size());
+      if (Inserted) {
+        States.push_back(std::move(NextItems));
+      }
+      Transitions[State * CharClassesNumber + Class] = It->second;
+    }
+    AcceptInfo Accept{false, 0, 0};
+    for (size_t Item : StateItems) {
+      const auto *Pattern = Items.getAcceptedPattern(Item);
+      if (Pattern &&
+          (!Accept.Accepting || Pattern->getPriority() > Accept.Priority)) {
+        Accept = {true, Pattern->getTokenID(), Pattern->getPriority()};
+      }
+    }
+    Accepts.push_back(Accept);
+  }
+}
+
+void TokenDFA::minimize() {
+  size_t StatesNumber = Accepts.size();
+  std::vector<uint32_t> Blocks(StatesNumber);
+  std::map<std::tuple<bool, int, int>, uint32_t> AcceptBlocks;
+  for (size_t State = 0; State < StatesNumber; ++State) {
+    auto &Accept = Accepts[State];
+    auto Key = Accept.Accepting
+                   ? std::make_tuple(true, Accept.TokenID, Accept.Priority)
+                   : std::make_tuple(false, 0, 0);
+    Blocks[State] =
+        AcceptBlocks.emplace(Key, AcceptBlocks.size()).first->second;
+  }
+  size_t BlocksNumber = AcceptBlocks.size();
+  while (true) {
+    std::map<std::vector<uint32_t>, uint32_t> Signatures;
+    std::vector<uint32_t> NewBlocks(StatesNumber);
+    for (size_t State = 0; State < StatesNumber; ++State) {
+      std::vector<uint32_t> Signature;
+      Signature.reserve(CharClassesNumber + 1);
+      Signature.push_back(Blocks[State]);
+      for (size_t Class = 0; Class < CharClassesNumber; ++Class) {
+        Signature.push_back(
+            Blocks[Transitions[State * CharClassesNumber + Class]]);
+      }
+      NewBlocks[State] =
+          Signatures.emplace(std::move(Signature), Signatures.size())
+              .first->second;
+    }
+    Blocks = std::move(NewBlocks);
+    if (Signatures.size() == BlocksNumber) {
+      break;
+    }
+    BlocksNumber = Signatures.size();
+  }
+  assert(Blocks[DeadState] == DeadState &&
+         "Dead state should stay the first one");
+  std::vector<uint32_t> MinimizedTransitions(BlocksNumber * CharClassesNumber);
+  std::vector<AcceptInfo> MinimizedAccepts(BlocksNumber);
+  for (size_t State = 0; State < StatesNumber; ++State) {
+    size_t Block = Blocks[State];
+    MinimizedAccepts[Block] = Accepts[State];
+    for (size_t Class = 0; Class < CharClassesNumber; ++Class) {
+      MinimizedTransitions[Block * CharClassesNumber + Class] =
+          Blocks[Transitions[State * CharClassesNumber + Class]];
+    }
+  }
+  StartState = Blocks[StartState];
+  Transitions = std::move(MinimizedTransitions);
+  Accepts = std::move(MinimizedAccepts);
+}
+
+PatternItems::PatternItems(const std::vector<TokenPattern> &PatternsRef)
+    : Patterns(PatternsRef) {
+  for (size_t I = 0; I < Patterns.size(); ++I) {
+    Offsets.push_back(ItemPatterns.size());
+    ItemPatterns.insert(ItemPatterns.end(),
+                        Patterns[I].getElements().size() + 1, I);
+  }
+}
+
+std::vector<size_t> PatternItems::getStartItems() const {
+  std::vector<size_t> Items;
+  for (size_t Offset : Offsets) {
+    addClosure(Offset, Items);
+  }
+  std::sort(Items.begin(), Items.end());
+  Items.erase(std::unique(Items.begin(), Items.end()), Items.end());
+  return Items;
+}
+
+std::vector<size_t> PatternItems::step(const std::vector<size_t> &Items,
+                                       unsigned char Char) const {
+  std::vector<size_t> NextItems;
+  for (size_t Item : Items) {
+    size_t PatternIndex = ItemPatterns[Item];
+    size_t Position = Item - Offsets[PatternIndex];
+    auto &Elements = Patterns[PatternIndex].getElements();
+    if (Position == Elements.size() ||
+        !Elements[Position].Chars.contains(Char)) {
+      continue;
+    }
+    addClosure(Elements[Position].Repeated ? Item : Item + 1, NextItems);
+  }
+  std::sort(NextItems.begin(), NextItems.end());
+  NextItems.erase(std::unique(NextItems.begin(), NextItems.end()),
+                  NextItems.end());
+  return NextItems;
+}
+
+const TokenPattern *PatternItems::getAcceptedPattern(size_t Item) const {
+  size_t PatternIndex = ItemPatterns[Item];
+  size_t Position = Item - Offsets[PatternIndex];
+  if (Position != Patterns[PatternIndex].getElements().size()) {
+    return nullptr;
+  }
+  return &Patterns[PatternIndex];
+}
+
+void PatternItems::addClosure(size_t Item, std::vector<size_t> &Items) const {
+  size_t PatternIndex = ItemPatterns[Item];
+  auto &Elements = Patterns[PatternIndex].getElements();
+  size_t Position = Item - Offsets[PatternIndex];
+  Items.push_back(Item);
+  for (; Position < Elements.size() && Elements[Position].Repeated;
+       ++Position) {
+    Items.push_back(++Item);
+  }
+}
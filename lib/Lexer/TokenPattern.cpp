@@ -0,0 +1,63 @@
+#include "cowabunga/Lexer/TokenPattern.h"
+
+#include <cassert>
+
+using namespace cb;
+
+CharSet CharSet::range(unsigned char First, unsigned char Last) {
+  assert(First <= Last && "Range should not be empty");
+  CharSet Result;
+  for (unsigned Char = First; Char <= Last; ++Char) {
+    Result.Chars.set(Char);
+  }
+  return Result;
+}
+
+CharSet CharSet::of(std::string_view Chars) {
+  CharSet Result;
+  for (char Char : Chars) {
+    Result.Chars.set(static_cast<unsigned char>(Char));
+  }
+  return Result;
+}
+
+CharSet &CharSet::add(const CharSet &RHS) {
+  Chars |= RHS.Chars;
+  return *this;
+}
+
+bool CharSet::contains(unsigned char Char) const { return Chars.test(Char); }
+
+bool CharSet::empty() const { return Chars.none(); }
+
+TokenPattern::TokenPattern(int TokenID) : ID(TokenID), Priority(TokenID) {}
+
+TokenPattern::TokenPattern(int TokenID, int TokenPriority)
+    : ID(TokenID), Priority(TokenPriority) {}
+
+TokenPattern TokenPattern::literal(int TokenID, std::string_view Literal) {
+  TokenPattern Result(TokenID);
+  for (char Char : Literal) {
+    Result.one(CharSet::of(std::string_view(&Char, 1)));
+  }
+  return Result;
+}
+
+TokenPattern &TokenPattern::one(CharSet Chars) {
+  Elements.push_back({std::move(Chars), false});
+  return *this;
+}
+
+TokenPattern &TokenPattern::many(CharSet Chars) {
+  Elements.push_back({std::move(Chars), true});
+  return *this;
+}
+
+int TokenPattern::getTokenID() const noexcept { return ID; }
+
+int TokenPattern::getPriority() const noexcept { return Priority; }
+
+const std::vector<TokenPattern::Element> &
+TokenPattern::getElements() const noexcept {
+  return Elements;
+}
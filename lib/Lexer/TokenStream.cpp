@@ -0,0 +1,66 @@
+#include "cowabunga/Lexer/TokenStream.h"
+
+#include "LineTokenizer.h"
+
+#include <cassert>
+#include <cstdlib>
+#include <iostream>
+
+using namespace cb;
+
+TokenStream::TokenStream(std::unique_ptr<LineTokenizer> TokenizerImpl,
+                         size_t MaxLookahead)
+    : Tokenizer(std::move(TokenizerImpl)), LookaheadLimit(MaxLookahead),
+      Exhausted(false) {
+  assert(LookaheadLimit > 0 && "TokenStream should look at least one ahead");
+}
+
+TokenStream::TokenStream(TokenStream &&RHS) noexcept = default;
+
+TokenStream &TokenStream::operator=(TokenStream &&RHS) noexcept = default;
+
+TokenStream::~TokenStream() = default;
+
+const Token *TokenStream::peek(size_t Ahead) {
+  assert(Ahead < LookaheadLimit && "Lookahead limit is exceeded");
+  if (!fill(Ahead + 1)) {
+    return nullptr;
+  }
+  return &Lookahead[Ahead];
+}
+
+std::optional<Token> TokenStream::next() {
+  if (!fill(1)) {
+    return std::nullopt;
+  }
+  auto Tok = Lookahead.front();
+  Lookahead.pop_front();
+  return Tok;
+}
+
+size_t TokenStream::getLookaheadLimit() const noexcept {
+  return LookaheadLimit;
+}
+
+TokenStream::Iterator TokenStream::begin() { return Iterator(*this); }
+
+TokenStream::Iterator TokenStream::end() { return Iterator(); }
+
+TokenStream::operator bool() const noexcept { return *Tokenizer; }
+
+bool TokenStream::fill(size_t TokensNumber) {
+  while (Lookahead.size() < TokensNumber && !Exhausted) {
+    auto Tok = Tokenizer->next();
+    if (!Tok) {
+      Exhausted = true;
+      if (!*Tokenizer) {
+        std::cerr << "Failed to parse " << Tokenizer->getSource().getName()
+                  << std::endl;
+        exit(1);
+      }
+      break;
+    }
+    Lookahead.push_back(*Tok);
+  }
+  return Lookahead.size() >= TokensNumber;
+}
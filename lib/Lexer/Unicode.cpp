@@ -0,0 +1,92 @@
+#include "cowabunga/Lexer/Unicode.h"
+
+#include "cowabunga/Lexer/CharScanners.h"
+
+#include <cstdint>
+
+using namespace cb;
+
+namespace {
+
+#include "XIDTables.inc"
+
+constexpr char32_t MaxCodePoint = 0x10FFFF;
+
+/// Words 0-3 of every block are XID_Start bits, words 4-7 are XID_Continue
+/// ones.
+bool testXIDBit(char32_t CodePoint, unsigned FirstWord) {
+  if (CodePoint > MaxCodePoint) {
+    return false;
+  }
+  unsigned Bit = CodePoint & 0xFF;
+  uint64_t Word = XIDBlocks[XIDBlockIndex[CodePoint >> 8]][FirstWord + Bit / 64];
+  return (Word >> (Bit % 64)) & 1;
+}
+
+} // namespace
+
+size_t cb::scanValidUTF8(std::string_view Text) {
+  size_t Length = 0;
+  while (true) {
+    Length += scanASCII(Text.substr(Length));
+    if (Length == Text.length()) {
+      return Length;
+    }
+    size_t SequenceLength = decodeUTF8(Text.substr(Length)).second;
+    if (!SequenceLength) {
+      return Length;
+    }
+    Length += SequenceLength;
+  }
+}
+
+std::pair<char32_t, size_t> cb::decodeUTF8(std::string_view Text) {
+  if (Text.empty()) {
+    return std::make_pair(0, 0);
+  }
+  auto Lead = static_cast<unsigned char>(Text.front());
+  if (Lead < 0x80) {
+    return std::make_pair(Lead, 1);
+  }
+  size_t Length;
+  char32_t CodePoint;
+  char32_t MinCodePoint;
+  if ((Lead & 0xE0) == 0xC0) {
+    Length = 2;
+    CodePoint = Lead & 0x1F;
+    MinCodePoint = 0x80;
+  } else if ((Lead & 0xF0) == 0xE0) {
+    Length = 3;
+    CodePoint = Lead & 0x0F;
+    MinCodePoint = 0x800;
+  } else if ((Lead & 0xF8) == 0xF0) {
+    Length = 4;
+    CodePoint = Lead & 0x07;
+    MinCodePoint = 0x10000;
+  } else {
+    return std::make_pair(0, 0);
+  }
+  if (Text.length() < Length) {
+    return std::make_pair(0, 0);
+  }
+  for (size_t I = 1; I < Length; ++I) {
+    auto Continuation = static_cast<unsigned char>(Text[I]);
+    if ((Continuation & 0xC0) != 0x80) {
+      return std::make_pair(0, 0);
+    }
+    CodePoint = (CodePoint << 6) | (Continuation & 0x3F);
+  }
+  // Reject overlong encodings, surrogates and code points above the Unicode
+  // range.
+  if (CodePoint < MinCodePoint || CodePoint > MaxCodePoint ||
+      (CodePoint >= 0xD800 && CodePoint <= 0xDFFF)) {
+    return std::make_pair(0, 0);
+  }
+  return std::make_pair(CodePoint, Length);
+}
+
+bool cb::isXIDStart(char32_t CodePoint) { return testXIDBit(CodePoint, 0); }
+
+bool cb::isXIDContinue(char32_t CodePoint) {
+  return testXIDBit(CodePoint, 4);
+}
@@ -3,13 +3,23 @@
 #include "cowabunga/Common/IClonableMixin.h"
 #include "cowabunga/Lexer/Lexer.h"
 #include "cowabunga/Parser/CFGParserError.h"
+#include "cowabunga/Parser/EarleyParser.h"
+#include "cowabunga/Parser/GrammarIndex.h"
 #include "cowabunga/Parser/ICFGRule.h"
+#include "cowabunga/Parser/LALRTable.h"
+#include "cowabunga/Parser/LL1Table.h"
 #include "cowabunga/Parser/Symbol.h"
 
+#include <algorithm>
 #include <cassert>
 #include <cstddef>
+#include <cstdint>
 #include <iostream>
+#include <iterator>
+#include <limits>
 #include <memory>
+#include <optional>
+#include <unordered_map>
 #include <utility>
 #include <vector>
 
@@ -17,9 +27,136 @@ using namespace cb;
 
 namespace {
 
+/// Cells of persistent stacks of all ParserNodes made during one parsing.
+/// Cells are immutable, so a copy of ParserNode shares everything below the
+/// tops of its stacks. Leaves of the parsing tree are explored depth first,
+/// so cells made after a leaf can be released once the leaf is reached
+/// again.
+class ParserNodePool final {
+public:
+  struct SymbolCell {
+    Symbol Sym;
+    /// Rule which has produced Sym.
+    ICFGRule *Owner;
+    uint32_t Next;
+  };
+
+  struct TraceCell {
+    ICFGRule *Rule;
+    TokenIterator ItToken;
+    uint32_t Previous;
+  };
+
+  struct Mark {
+    uint32_t SymbolsNumber;
+    uint32_t TracesNumber;
+  };
+
+  /// Index of the bottom of every stack.
+  static constexpr uint32_t Nil = 0;
+
+  ParserNodePool();
+
+  Mark getMark() const noexcept;
+
+  /// Releases all cells made after PoolMark.
+  void release(Mark PoolMark);
+
+  uint32_t pushSymbol(Symbol Sym, ICFGRule *Owner, uint32_t Next);
+
+  uint32_t pushTrace(ICFGRule *Rule, TokenIterator ItToken, uint32_t Previous);
+
+  const SymbolCell &getSymbol(uint32_t Cell) const;
+
+  const TraceCell &getTrace(uint32_t Cell) const;
+
+  void clear();
+
+private:
+  std::vector<SymbolCell> Symbols;
+  std::vector<TraceCell> Traces;
+};
+
+/// PackratMemo remembers where derivations of nonterminals starting at token
+/// positions end. A derivation of a nonterminal ends when a node's symbol
+/// stack shrinks back to the cell which was below the nonterminal. Ends are
+/// published once the whole parsing subtree of the nonterminal has been
+/// explored, so a later expansion of the same nonterminal at the same
+/// position may jump straight to them. Remembered ends refer to cells of
+/// ParserNodePool, so the pool isn't released while the memo records.
+class PackratMemo final {
+public:
+  struct DerivationEnd {
+    TokenIterator ItInput;
+    /// Steps of the derivation are trace cells from TraceTop down to
+    /// TraceBottom, exclusive.
+    uint32_t TraceTop;
+    uint32_t TraceBottom;
+    ICFGRule *LatestUsedRule;
+  };
+
+  PackratMemo(TokenIterator ItInputBegin, size_t RecordsLimit);
+
+  /// Returns ends of all derivations of NonTerminal at ItInput in order they
+  /// have been found, or nullptr if they aren't known.
+  const std::vector<DerivationEnd> *lookup(Symbol NonTerminal,
+                                           TokenIterator ItInput);
+
+  /// Starts recording derivations of NonTerminal at ItInput. Below is the
+  /// symbol cell under NonTerminal, LeavesNumber is the number of leaves of
+  /// the parsing tree without the ones which will be derived.
+  void beginDerivations(Symbol NonTerminal, TokenIterator ItInput,
+                        uint32_t Below, uint32_t TraceBottom,
+                        size_t LeavesNumber);
+
+  /// Publishes derivations whose subtrees have been explored.
+  void finishDerivations(size_t LeavesNumber);
+
+  /// Forgets all derivations and stops recording if records together with
+  /// PoolCells kept cells of ParserNodePool exceed the limit.
+  void checkLimit(size_t PoolCells);
+
+  bool isRecording() const noexcept;
+
+  bool isDerivationEnd(uint32_t SymbolCell) const noexcept;
+
+  void addDerivationEnd(uint32_t SymbolCell, TokenIterator ItInput,
+                        uint32_t TraceTop, ICFGRule *LatestUsedRule);
+
+  const CFGParserMemoStats &getStats() const noexcept;
+
+private:
+  static constexpr size_t NoDerivation = std::numeric_limits<size_t>::max();
+
+  struct OpenDerivation {
+    uint64_t Key;
+    uint32_t Below;
+    uint32_t TraceBottom;
+    size_t LeavesNumber;
+    size_t PreviousWithSameBelow;
+    std::vector<DerivationEnd> Ends;
+  };
+
+  uint64_t getKey(Symbol NonTerminal, TokenIterator ItInput) const;
+
+  TokenIterator ItBegin;
+  size_t Limit;
+  bool Recording = true;
+  /// Derivations which are being recorded are mapped to nullopt.
+  std::unordered_map<uint64_t, std::optional<std::vector<DerivationEnd>>>
+      Derivations;
+  std::vector<OpenDerivation> Open;
+  /// Maps symbol cells to the innermost open derivation which ends there.
+  std::vector<size_t> OpenByBelow;
+  CFGParserMemoStats Stats;
+};
+
+/// ParserNode is a leaf of the parsing tree. Its symbol stack and trace are
+/// stored in ParserNodePool, so copying a node takes constant time.
 class ParserNode final {
 public:
-  ParserNode(Symbol StartSymbol, TokenIterator ItInputBegin,
+  ParserNode(ParserNodePool &NodePool, PackratMemo *DerivationsMemo,
+             Symbol StartSymbol, TokenIterator ItInputBegin,
              TokenIterator ItInputEnd);
 
   bool parseFrontTerminals();
@@ -40,31 +177,49 @@ public:
 
   std::vector<std::pair<ICFGRule *, TokenIterator>> getParsingTrace();
 
-  void applyRule(ICFGRule *Rule);
+  void applyRule(ICFGRule *Rule, ProductsRange Products);
+
+  /// Replaces the top nonterminal with its remembered derivation.
+  void applyDerivation(const PackratMemo::DerivationEnd &Derivation);
 
   TokenIterator getInputIterator() const noexcept;
 
+  uint32_t getSymbolBelowTop() const;
+
+  uint32_t getTraceTop() const noexcept;
+
+  /// Tells Memo if the node has just finished derivations which are being
+  /// recorded.
+  void checkDerivationEnd();
+
+  /// Returns mark of the pool right after the node was made.
+  ParserNodePool::Mark getPoolMark() const noexcept;
+
 private:
-  void updateRuleStack();
+  void popSymbol();
 
+  ParserNodePool *Pool;
+  PackratMemo *Memo;
   TokenIterator ItInput;
   TokenIterator ItEnd;
-  std::vector<std::pair<ICFGRule *, TokenIterator>> Trace;
-  std::stack<std::pair<ICFGRule *, size_t>> RuleStack;
-  std::stack<Symbol> SymbolStack;
+  uint32_t SymbolTop;
+  uint32_t TraceTop;
   ICFGRule *LatestUsedRule;
+  ParserNodePool::Mark PoolMark;
 };
 
 class CFGParserImpl final {
 public:
-  using CFGRuleIterator = std::vector<std::unique_ptr<ICFGRule>>::iterator;
-
-  CFGParserImpl(Symbol StartSymbol,
-                std::vector<std::unique_ptr<ICFGRule>> &CFGRules);
+  CFGParserImpl(const GrammarIndex &GrammarRules, const LL1Table *PredictTable,
+                size_t MemoLimit, CFGParserActionMode Mode);
 
   void parse(TokenIterator ItBegin, TokenIterator ItEnd);
 
+  const CFGParserMemoStats &getMemoStats() const noexcept;
+
 private:
+  void runParsing(TokenIterator ItBegin, TokenIterator ItEnd);
+
   void parsingLoop();
 
   void prepareError(ParserNode &Node);
@@ -75,33 +230,200 @@ private:
 
   void finishParsingOrMakeError(std::shared_ptr<ParserNode> Node);
 
-  std::pair<CFGRuleIterator, CFGRuleIterator>
-  findRulesForNonTerminal(Symbol NonTerminal) const;
-
-  static bool compareByNonTerminalID(const std::unique_ptr<ICFGRule> &LHS,
-                                     int RHS);
-
-  CFGRuleIterator findFirstRuleForNonTerminalID(
-      int NonTerminalID,
-      bool (*Less)(const std::unique_ptr<ICFGRule> &LHS, int RHS)) const;
-
   std::stack<ParserNode> ParsingTreeLeaves;
+  ParserNodePool Pool;
+  std::unique_ptr<PackratMemo> Memo;
+  CFGParserMemoStats MemoStats;
   CFGParserError Error;
-  Symbol Start;
-  std::vector<std::unique_ptr<ICFGRule>> &Rules;
+  const GrammarIndex &Grammar;
+  const LL1Table *Table;
+  size_t MemoRecordsLimit;
+  CFGParserActionMode ActionMode;
   bool Success;
 };
 
+/// TokenInput feeds parsers which look one token ahead: it walks a range of
+/// tokens, or pulls tokens from a TokenStream as parsing goes. Parsers keep
+/// marks of tokens where rules begin. A mark in a range is an iterator, a
+/// mark in a stream is a copy of the token, so the stream isn't buffered.
+class TokenInput final {
+public:
+  struct Mark {
+    TokenIterator ItToken;
+    /// Copy of the token pulled from a stream, nullopt at the end of input.
+    std::optional<Token> Tok;
+  };
+
+  TokenInput(TokenIterator ItBegin, TokenIterator ItInputEnd);
+
+  explicit TokenInput(TokenStream &Tokens);
+
+  /// Returns ID of the next token, or EndOfInput.
+  int getLookahead();
+
+  void shift();
+
+  /// Returns mark of the next token.
+  Mark getMark();
+
+  /// Returns iterator to the marked token. Rules given tokens of a stream
+  /// may only dereference it, and it is valid until the next resolve.
+  TokenIterator resolve(const Mark &Marked);
+
+  /// Resolves marks of all Rules at once.
+  std::vector<std::pair<ICFGRule *, TokenIterator>>
+  resolve(const std::vector<std::pair<ICFGRule *, Mark>> &Rules);
+
+  /// Makes Error point to the next token, or to the latest shifted one at
+  /// the end of input.
+  void setFoundToken(CFGParserError &Error);
+
+private:
+  TokenIterator ItInput;
+  TokenIterator ItEnd;
+  TokenStream *Stream;
+  std::optional<Token> Latest;
+  std::vector<Token> Resolved;
+};
+
+/// LL1ParserImpl parses input of an LL(1) grammar without backtracking. It
+/// records the same derivation as CFGParserImpl does and replays it the same
+/// way. Rules are streamed once all of their products have been read.
+class LL1ParserImpl final {
+public:
+  LL1ParserImpl(const GrammarIndex &GrammarRules, const LL1Table &PredictTable,
+                CFGParserActionMode Mode);
+
+  void parse(TokenInput &Input);
+
+private:
+  struct StackEntry {
+    Symbol Sym;
+    ICFGRule *Owner;
+  };
+
+  /// Rule which has been predicted but not committed yet.
+  struct OpenRule {
+    ICFGRule *Rule;
+    TokenInput::Mark Token;
+    /// Number of products which haven't been read yet.
+    size_t ProductsLeft;
+  };
+
+  /// Applies open rules which have all of their products read.
+  void commitRules(TokenInput &Input);
+
+  void produceError(TokenInput &Input);
+
+  /// Returns terminal which begins derivations of Sym made with the first
+  /// rules of nonterminals, or Sym itself if there is no such terminal.
+  Symbol getExpectedSymbol(Symbol Sym) const;
+
+  std::vector<StackEntry> Stack;
+  std::vector<std::pair<ICFGRule *, TokenInput::Mark>> Trace;
+  std::vector<OpenRule> OpenRules;
+  ICFGRule *LatestUsedRule;
+  const GrammarIndex &Grammar;
+  const LL1Table &Table;
+  CFGParserActionMode ActionMode;
+};
+
+/// LALRParserImpl is a shift-reduce parser driven by LALR(1) tables. Rules
+/// are streamed as soon as they are reduced. Otherwise reductions are linked
+/// into the derivation tree and replayed as CFGParserImpl does.
+class LALRParserImpl final {
+public:
+  LALRParserImpl(const GrammarIndex &GrammarRules, const LALRTableData &Data,
+                 CFGParserActionMode Mode);
+
+  void parse(TokenInput &Input);
+
+private:
+  struct StackEntry {
+    uint32_t State;
+    /// Reduction which has produced the symbol, None for terminals.
+    uint32_t Reduction;
+    /// First token of the symbol.
+    TokenInput::Mark Token;
+  };
+
+  struct Reduction {
+    uint32_t Rule;
+    /// Reductions of nonterminal products are
+    /// Children[ChildrenBegin:ChildrenEnd].
+    uint32_t ChildrenBegin;
+    uint32_t ChildrenEnd;
+    TokenInput::Mark Token;
+  };
+
+  static constexpr uint32_t None = std::numeric_limits<uint32_t>::max();
+
+  void reduce(uint32_t Rule, TokenInput &Input);
+
+  void applyDerivation(uint32_t Root, TokenInput &Input);
+
+  void produceError(uint32_t State, TokenInput &Input);
+
+  std::vector<StackEntry> Stack;
+  std::vector<Reduction> Reductions;
+  std::vector<uint32_t> Children;
+  const GrammarIndex &Grammar;
+  const LALRTableData &Tables;
+  CFGParserActionMode ActionMode;
+};
+
+/// Applies rules of a derivation, which are given in preorder, as Mode
+/// tells.
+void applyRules(
+    const std::vector<std::pair<ICFGRule *, TokenIterator>> &Rules,
+    CFGParserActionMode Mode, const GrammarIndex &Grammar) {
+  if (Mode == CFGParserActionMode::Replay) {
+    for (auto It = Rules.rbegin(), ItEnd = Rules.rend(); It != ItEnd; ++It) {
+      It->first->parse(It->second);
+    }
+    return;
+  }
+  std::unordered_map<ICFGRule *, size_t> NonTerminalsNumbers;
+  for (size_t Rule = 0; Rule < Grammar.getRulesNumber(); ++Rule) {
+    auto Products = Grammar.getProducts(Rule);
+    NonTerminalsNumbers[Grammar.getRule(Rule)] = std::count_if(
+        Products.begin(), Products.end(),
+        [](const Symbol &Product) { return Product.isNonTerminal(); });
+  }
+  // Rules which wait for some of their nonterminal products, and numbers of
+  // such products.
+  std::vector<std::pair<size_t, size_t>> Open;
+  for (size_t I = 0; I < Rules.size(); ++I) {
+    Open.emplace_back(I, NonTerminalsNumbers[Rules[I].first]);
+    while (!Open.empty() && !Open.back().second) {
+      auto &[Rule, ItToken] = Rules[Open.back().first];
+      Rule->parse(ItToken);
+      Open.pop_back();
+      if (!Open.empty()) {
+        --Open.back().second;
+      }
+    }
+  }
+}
+
 } // namespace
 
 CFGParser::CFGParser(Symbol StartNonTerminal)
     : StartSymbol(std::move(StartNonTerminal)) {}
 
-CFGParser::CFGParser(const CFGParser &RHS) : StartSymbol(RHS.StartSymbol) {
+CFGParser::CFGParser(const CFGParser &RHS)
+    : StartSymbol(RHS.StartSymbol), MemoLimit(RHS.MemoLimit),
+      Algorithm(RHS.Algorithm), ActionMode(RHS.ActionMode) {
   Rules.reserve(RHS.Rules.size());
-  for (auto &Rule : Rules) {
+  for (auto &Rule : RHS.Rules) {
     Rules.push_back(Rule->clone());
   }
+  if (!RHS.LRTable) {
+    LRData = RHS.LRData;
+  }
+  if (RHS.isCompiled()) {
+    compile();
+  }
 }
 
 CFGParser &CFGParser::operator=(const CFGParser &RHS) {
@@ -111,31 +433,189 @@ CFGParser &CFGParser::operator=(const CFGParser &RHS) {
 }
 
 void CFGParser::parse(TokenIterator ItBegin, TokenIterator ItEnd) {
+  MemoStats = CFGParserMemoStats();
   if (ItBegin == ItEnd) {
     return;
   }
-  CFGParserImpl Impl(StartSymbol, Rules);
+  if (Table && Table->isLL1()) {
+    TokenInput Input(ItBegin, ItEnd);
+    LL1ParserImpl Impl(*Grammar, *Table, ActionMode);
+    Impl.parse(Input);
+    return;
+  }
+  if (Algorithm == CFGParserAlgorithm::Earley) {
+    EarleyParser Impl(getGrammarIndex());
+    applyRules(Impl.parse(ItBegin, ItEnd), ActionMode, *Grammar);
+    return;
+  }
+  if (Algorithm == CFGParserAlgorithm::LALR) {
+    auto &Data = getLALRTable();
+    if (!Data.ConflictsNumber) {
+      TokenInput Input(ItBegin, ItEnd);
+      LALRParserImpl Impl(*Grammar, Data, ActionMode);
+      Impl.parse(Input);
+      return;
+    }
+  }
+  CFGParserImpl Impl(getGrammarIndex(), Table.get(), MemoLimit, ActionMode);
   Impl.parse(ItBegin, ItEnd);
+  MemoStats = Impl.getMemoStats();
 }
 
-CFGParserImpl::CFGParserImpl(Symbol StartSymbol,
-                             std::vector<std::unique_ptr<ICFGRule>> &CFGRules)
-    : Start(StartSymbol), Rules(CFGRules) {}
+void CFGParser::parse(TokenStream &Tokens) {
+  MemoStats = CFGParserMemoStats();
+  if (!Tokens.peek()) {
+    return;
+  }
+  if (Table && Table->isLL1()) {
+    TokenInput Input(Tokens);
+    LL1ParserImpl Impl(*Grammar, *Table, ActionMode);
+    Impl.parse(Input);
+    return;
+  }
+  if (Algorithm == CFGParserAlgorithm::LALR &&
+      !getLALRTable().ConflictsNumber) {
+    TokenInput Input(Tokens);
+    LALRParserImpl Impl(*Grammar, getLALRTable(), ActionMode);
+    Impl.parse(Input);
+    return;
+  }
+  // Backtracking and Earley parsing may return to any token read so far.
+  std::vector<Token> ReadTokens(Tokens.begin(), Tokens.end());
+  parse(ReadTokens.cbegin(), ReadTokens.cend());
+}
+
+bool CFGParser::compile() {
+  Table = std::make_unique<LL1Table>(getGrammarIndex());
+  bool Linear = Table->isLL1();
+  if (Algorithm == CFGParserAlgorithm::LALR) {
+    Linear |= !getLALRTable().ConflictsNumber;
+  }
+  return Linear;
+}
+
+bool CFGParser::isCompiled() const noexcept { return Table != nullptr; }
+
+const std::vector<LL1Conflict> &CFGParser::getConflicts() const {
+  static const std::vector<LL1Conflict> NoConflicts;
+  return Table ? Table->getConflicts() : NoConflicts;
+}
+
+const std::vector<LALRConflict> &CFGParser::getLALRConflicts() const {
+  static const std::vector<LALRConflict> NoConflicts;
+  return LRTable ? LRTable->getConflicts() : NoConflicts;
+}
+
+bool CFGParser::setLALRTable(const LALRTableData &Data) {
+  if (!LALRTable::matches(Data, getGrammarIndex())) {
+    return false;
+  }
+  LRTable.reset();
+  LRData = &Data;
+  return true;
+}
+
+bool CFGParser::writeLALRTable(std::ostream &OS, const std::string &Name) {
+  if (!LRTable) {
+    LRTable = std::make_unique<LALRTable>(getGrammarIndex());
+    LRData = &LRTable->getData();
+  }
+  if (!LRTable->isLALR1()) {
+    return false;
+  }
+  LRTable->writeHeader(OS, Name);
+  return true;
+}
+
+void CFGParser::setMemoLimit(size_t Limit) noexcept { MemoLimit = Limit; }
+
+const CFGParserMemoStats &CFGParser::getMemoStats() const noexcept {
+  return MemoStats;
+}
+
+void CFGParser::setAlgorithm(CFGParserAlgorithm NewAlgorithm) noexcept {
+  Algorithm = NewAlgorithm;
+}
+
+void CFGParser::setActionMode(CFGParserActionMode NewMode) noexcept {
+  ActionMode = NewMode;
+}
+
+const GrammarIndex &CFGParser::getGrammarIndex() {
+  if (!Grammar) {
+    Grammar = std::make_unique<GrammarIndex>(StartSymbol, Rules);
+  }
+  return *Grammar;
+}
+
+const LALRTableData &CFGParser::getLALRTable() {
+  if (!LRData) {
+    LRTable = std::make_unique<LALRTable>(getGrammarIndex());
+    LRData = &LRTable->getData();
+  }
+  return *LRData;
+}
+
+CFGParserImpl::CFGParserImpl(const GrammarIndex &GrammarRules,
+                             const LL1Table *PredictTable, size_t MemoLimit,
+                             CFGParserActionMode Mode)
+    : Grammar(GrammarRules), Table(PredictTable), MemoRecordsLimit(MemoLimit),
+      ActionMode(Mode) {}
 
 void CFGParserImpl::parse(TokenIterator ItBegin, TokenIterator ItEnd) {
+  runParsing(ItBegin, ItEnd);
+  if (!Success && (Table || MemoRecordsLimit)) {
+    // The error is chosen among all explored alternatives, including the
+    // skipped and remembered ones, so it is searched for again without
+    // skipping.
+    Table = nullptr;
+    MemoRecordsLimit = 0;
+    runParsing(ItBegin, ItEnd);
+  }
+  if (!Success) {
+    Error.FailedRule->produceError(Error);
+  }
+}
+
+const CFGParserMemoStats &CFGParserImpl::getMemoStats() const noexcept {
+  return MemoStats;
+}
+
+void CFGParserImpl::runParsing(TokenIterator ItBegin, TokenIterator ItEnd) {
   Error.ItFoundToken = ItBegin;
   Success = false;
-  ParsingTreeLeaves.push(ParserNode(Start, ItBegin, ItEnd));
+  Pool.clear();
+  Memo.reset();
+  if (MemoRecordsLimit) {
+    Memo = std::make_unique<PackratMemo>(ItBegin, MemoRecordsLimit);
+  }
+  ParsingTreeLeaves.push(ParserNode(Pool, Memo.get(), Grammar.getStartSymbol(),
+                                    ItBegin, ItEnd));
   parsingLoop();
-  if (!Success) {
-    Error.FailedRule->produceError(Error);
+  if (Memo) {
+    MemoStats = Memo->getStats();
   }
 }
 
 void CFGParserImpl::parsingLoop() {
   while (!ParsingTreeLeaves.empty()) {
+    if (Memo) {
+      Memo->finishDerivations(ParsingTreeLeaves.size());
+    }
     auto Leaf = ParsingTreeLeaves.top();
     ParsingTreeLeaves.pop();
+    // Nodes which have applied empty rules or remembered derivations may
+    // stop right at the end of a derivation. They are checked here rather
+    // than when created, so that ends are found in order of exploration.
+    Leaf.checkDerivationEnd();
+    if (Memo) {
+      auto PoolMark = Pool.getMark();
+      Memo->checkLimit(PoolMark.SymbolsNumber + PoolMark.TracesNumber);
+    }
+    // Remembered derivations refer to cells of explored leaves.
+    if (!Memo || !Memo->isRecording()) {
+      Pool.release(Leaf.getPoolMark());
+    }
     bool Matched = Leaf.parseFrontTerminals();
     if (!Matched) {
       prepareError(Leaf);
@@ -167,12 +647,7 @@ void CFGParserImpl::prepareError(ParserNode &Node) {
 
 void CFGParserImpl::finishParsing(ParserNode &Node) {
   Success = true;
-  auto Trace = Node.getParsingTrace();
-  auto It = Trace.rbegin();
-  auto ItEnd = Trace.rend();
-  for (; It != ItEnd; ++It) {
-    It->first->parse(It->second);
-  }
+  applyRules(Node.getParsingTrace(), ActionMode, Grammar);
   while (!ParsingTreeLeaves.empty()) {
     ParsingTreeLeaves.pop();
   }
@@ -180,65 +655,457 @@ void CFGParserImpl::finishParsing(ParserNode &Node) {
 
 void CFGParserImpl::extendParsingTree(const ParserNode &Node) {
   auto NonTerminal = Node.getTopNonTerminal();
-  auto [ItBegin, ItEnd] = findRulesForNonTerminal(NonTerminal);
-  for (; ItBegin != ItEnd; ++ItBegin) {
+  if (Memo) {
+    if (auto *Derivations =
+            Memo->lookup(NonTerminal, Node.getInputIterator())) {
+      for (auto It = Derivations->rbegin(), ItEnd = Derivations->rend();
+           It != ItEnd; ++It) {
+        auto NewNode = Node;
+        NewNode.applyDerivation(*It);
+        ParsingTreeLeaves.push(std::move(NewNode));
+      }
+      return;
+    }
+    Memo->beginDerivations(NonTerminal, Node.getInputIterator(),
+                           Node.getSymbolBelowTop(), Node.getTraceTop(),
+                           ParsingTreeLeaves.size());
+  }
+  auto [RulesBegin, RulesEnd] = Grammar.getRules(NonTerminal.getID());
+  int Lookahead = Node.getInputIterator()->getID();
+  for (size_t Rule = RulesBegin; Rule < RulesEnd; ++Rule) {
+    if (Table && !Table->predicts(Rule, Lookahead)) {
+      continue;
+    }
     auto NewNode = Node;
-    NewNode.applyRule(ItBegin->get());
+    NewNode.applyRule(Grammar.getRule(Rule), Grammar.getProducts(Rule));
     ParsingTreeLeaves.push(std::move(NewNode));
   }
 }
 
-std::pair<CFGParserImpl::CFGRuleIterator, CFGParserImpl::CFGRuleIterator>
-CFGParserImpl::findRulesForNonTerminal(Symbol NonTerminal) const {
-  int NonTerminalID = NonTerminal.getID();
-  auto ItBegin =
-      findFirstRuleForNonTerminalID(NonTerminalID, compareByNonTerminalID);
-  auto ItEnd =
-      findFirstRuleForNonTerminalID(NonTerminalID + 1, compareByNonTerminalID);
-  return std::make_pair(ItBegin, ItEnd);
+LL1ParserImpl::LL1ParserImpl(const GrammarIndex &GrammarRules,
+                             const LL1Table &PredictTable,
+                             CFGParserActionMode Mode)
+    : LatestUsedRule(nullptr), Grammar(GrammarRules), Table(PredictTable),
+      ActionMode(Mode) {}
+
+void LL1ParserImpl::parse(TokenInput &Input) {
+  Stack.push_back(StackEntry{Grammar.getStartSymbol(), nullptr});
+  while (!Stack.empty()) {
+    auto Top = Stack.back();
+    int Lookahead = Input.getLookahead();
+    if (Top.Sym.isTerminal()) {
+      if (Lookahead != Top.Sym.getID()) {
+        produceError(Input);
+        return;
+      }
+      Stack.pop_back();
+      LatestUsedRule = Top.Owner;
+      Input.shift();
+      if (ActionMode == CFGParserActionMode::Streaming) {
+        --OpenRules.back().ProductsLeft;
+        commitRules(Input);
+      }
+      continue;
+    }
+    auto &Predicted = Table.getPredictedRules(Top.Sym.getID(), Lookahead);
+    if (Predicted.empty()) {
+      produceError(Input);
+      return;
+    }
+    assert(Predicted.size() == 1 && "Grammar should be LL(1)");
+    ICFGRule *Rule = Grammar.getRule(Predicted.front());
+    auto Products = Grammar.getProducts(Predicted.front());
+    Stack.pop_back();
+    LatestUsedRule = Top.Owner;
+    for (auto It = Products.rbegin(), ItProductsEnd = Products.rend();
+         It != ItProductsEnd; ++It) {
+      Stack.push_back(StackEntry{*It, Rule});
+    }
+    if (ActionMode == CFGParserActionMode::Streaming) {
+      OpenRules.push_back(OpenRule{Rule, Input.getMark(), Products.size()});
+      commitRules(Input);
+    } else {
+      Trace.push_back(std::make_pair(Rule, Input.getMark()));
+    }
+  }
+  if (Input.getLookahead() != LL1Table::EndOfInput) {
+    produceError(Input);
+    return;
+  }
+  applyRules(Input.resolve(Trace), ActionMode, Grammar);
 }
 
-bool CFGParserImpl::compareByNonTerminalID(const std::unique_ptr<ICFGRule> &LHS,
-                                           int RHS) {
-  return LHS->getLHSNonTerminal().getID() < RHS;
+void LL1ParserImpl::commitRules(TokenInput &Input) {
+  while (!OpenRules.empty() && !OpenRules.back().ProductsLeft) {
+    OpenRules.back().Rule->parse(Input.resolve(OpenRules.back().Token));
+    OpenRules.pop_back();
+    if (!OpenRules.empty()) {
+      --OpenRules.back().ProductsLeft;
+    }
+  }
 }
 
-CFGParserImpl::CFGRuleIterator CFGParserImpl::findFirstRuleForNonTerminalID(
-    int NonTerminalID,
-    bool (*Less)(const std::unique_ptr<ICFGRule> &LHS, int RHS)) const {
-  auto Distance = Rules.size();
-  CFGRuleIterator ItBegin = Rules.begin();
-  CFGRuleIterator It;
-  while (Distance > 0) {
-    auto Step = Distance / 2;
-    It = ItBegin + Step;
-    if (Less(*It, NonTerminalID)) {
-      ItBegin = ++It;
-      Distance -= Step + 1;
-    } else {
-      Distance = Step;
+void LL1ParserImpl::produceError(TokenInput &Input) {
+  CFGParserError Error;
+  Error.EOFExpected = Stack.empty();
+  Input.setFoundToken(Error);
+  Error.FailedRule = LatestUsedRule;
+  if (!Error.EOFExpected) {
+    Error.ExpectedSymbol = getExpectedSymbol(Stack.back().Sym);
+    if (Stack.back().Owner) {
+      Error.FailedRule = Stack.back().Owner;
     }
   }
-  return ItBegin;
+  if (!Error.FailedRule) {
+    auto [RulesBegin, RulesEnd] =
+        Grammar.getRules(Grammar.getStartSymbol().getID());
+    Error.FailedRule = Grammar.getRule(RulesBegin != RulesEnd ? RulesBegin : 0);
+  }
+  Error.FailedRule->produceError(Error);
 }
 
-ParserNode::ParserNode(Symbol StartSymbol, TokenIterator ItInputBegin,
-                       TokenIterator ItInputEnd)
-    : ItInput(ItInputBegin), ItEnd(ItInputEnd), LatestUsedRule(nullptr) {
-  SymbolStack.push(StartSymbol);
-  RuleStack.push(std::make_pair(nullptr, 1));
+Symbol LL1ParserImpl::getExpectedSymbol(Symbol Sym) const {
+  auto Expected = Sym;
+  for (size_t Step = 0;
+       Step < Grammar.getRulesNumber() && Expected.isNonTerminal(); ++Step) {
+    auto [RulesBegin, RulesEnd] = Grammar.getRules(Expected.getID());
+    if (RulesBegin == RulesEnd || Grammar.getProducts(RulesBegin).empty()) {
+      return Sym;
+    }
+    Expected = Grammar.getProducts(RulesBegin).front();
+  }
+  return Expected.isTerminal() ? Expected : Sym;
 }
 
+LALRParserImpl::LALRParserImpl(const GrammarIndex &GrammarRules,
+                               const LALRTableData &Data,
+                               CFGParserActionMode Mode)
+    : Grammar(GrammarRules), Tables(Data), ActionMode(Mode) {}
+
+void LALRParserImpl::parse(TokenInput &Input) {
+  Stack.push_back(StackEntry{0, None, Input.getMark()});
+  while (true) {
+    uint32_t State = Stack.back().State;
+    uint32_t Action = LALRTable::AK_Error;
+    int Lookahead = Input.getLookahead();
+    if (Lookahead >= LALRTable::EndOfInput &&
+        static_cast<uint32_t>(Lookahead + 1) < Tables.ColumnsNumber) {
+      Action = Tables.Actions[State * Tables.ColumnsNumber + Lookahead + 1];
+    }
+    switch (LALRTable::getActionKind(Action)) {
+    case LALRTable::AK_Shift:
+      Stack.push_back(StackEntry{LALRTable::getActionValue(Action), None,
+                                 Input.getMark()});
+      Input.shift();
+      break;
+    case LALRTable::AK_Reduce:
+      reduce(LALRTable::getActionValue(Action), Input);
+      break;
+    case LALRTable::AK_Accept:
+      if (ActionMode == CFGParserActionMode::Replay) {
+        applyDerivation(Stack.back().Reduction, Input);
+      }
+      return;
+    case LALRTable::AK_Error:
+      produceError(State, Input);
+      return;
+    }
+  }
+}
+
+void LALRParserImpl::reduce(uint32_t Rule, TokenInput &Input) {
+  size_t Length =
+      Tables.ProductOffsets[Rule + 1] - Tables.ProductOffsets[Rule];
+  assert(Length < Stack.size() && "Stack should hold all products");
+  size_t First = Stack.size() - Length;
+  auto RuleToken = Length ? Stack[First].Token : Input.getMark();
+  uint32_t RuleReduction = None;
+  if (ActionMode == CFGParserActionMode::Streaming) {
+    Grammar.getRule(Rule)->parse(Input.resolve(RuleToken));
+  } else {
+    Reduction NewReduction{Rule, static_cast<uint32_t>(Children.size()), 0,
+                           RuleToken};
+    for (size_t I = First; I < Stack.size(); ++I) {
+      if (Stack[I].Reduction != None) {
+        Children.push_back(Stack[I].Reduction);
+      }
+    }
+    NewReduction.ChildrenEnd = static_cast<uint32_t>(Children.size());
+    RuleReduction = static_cast<uint32_t>(Reductions.size());
+    Reductions.push_back(NewReduction);
+  }
+  Stack.resize(First);
+  uint32_t Next = Tables.Gotos[Stack.back().State * Tables.NonTerminalsNumber +
+                               Tables.RuleNonTerminals[Rule]];
+  assert(Next && "Reduced nonterminal should have goto");
+  Stack.push_back(StackEntry{Next, RuleReduction, RuleToken});
+}
+
+void LALRParserImpl::applyDerivation(uint32_t Root, TokenInput &Input) {
+  // Reductions are linked in preorder, which is the order backtracking
+  // applies rules in.
+  std::vector<std::pair<ICFGRule *, TokenInput::Mark>> Preorder;
+  std::vector<uint32_t> Pending{Root};
+  while (!Pending.empty()) {
+    auto &Current = Reductions[Pending.back()];
+    Pending.pop_back();
+    Preorder.emplace_back(Grammar.getRule(Current.Rule), Current.Token);
+    for (uint32_t Child = Current.ChildrenEnd; Child > Current.ChildrenBegin;
+         --Child) {
+      Pending.push_back(Children[Child - 1]);
+    }
+  }
+  applyRules(Input.resolve(Preorder), ActionMode, Grammar);
+}
+
+void LALRParserImpl::produceError(uint32_t State, TokenInput &Input) {
+  CFGParserError Error;
+  Input.setFoundToken(Error);
+  Error.FailedRule = Grammar.getRule(Tables.StateRules[State]);
+  Error.EOFExpected = true;
+  const uint32_t *Row = Tables.Actions + State * Tables.ColumnsNumber;
+  for (uint32_t Column = 1; Column < Tables.ColumnsNumber; ++Column) {
+    if (LALRTable::getActionKind(Row[Column]) != LALRTable::AK_Error) {
+      Error.EOFExpected = false;
+      Error.ExpectedSymbol = terminal(static_cast<int>(Column) - 1);
+      break;
+    }
+  }
+  Error.FailedRule->produceError(Error);
+}
+
+TokenInput::TokenInput(TokenIterator ItBegin, TokenIterator ItInputEnd)
+    : ItInput(ItBegin), ItEnd(ItInputEnd), Stream(nullptr) {}
+
+TokenInput::TokenInput(TokenStream &Tokens) : Stream(&Tokens) {}
+
+int TokenInput::getLookahead() {
+  if (Stream) {
+    auto *Next = Stream->peek();
+    return Next ? Next->getID() : LL1Table::EndOfInput;
+  }
+  return ItInput == ItEnd ? LL1Table::EndOfInput : ItInput->getID();
+}
+
+void TokenInput::shift() {
+  if (Stream) {
+    Latest = Stream->next();
+  } else {
+    ++ItInput;
+  }
+}
+
+TokenInput::Mark TokenInput::getMark() {
+  if (Stream) {
+    auto *Next = Stream->peek();
+    return Mark{TokenIterator(), Next ? std::optional<Token>(*Next)
+                                      : std::nullopt};
+  }
+  return Mark{ItInput, std::nullopt};
+}
+
+TokenIterator TokenInput::resolve(const Mark &Marked) {
+  if (!Stream) {
+    return Marked.ItToken;
+  }
+  Resolved.clear();
+  if (Marked.Tok) {
+    Resolved.push_back(*Marked.Tok);
+  }
+  return Resolved.cbegin();
+}
+
+std::vector<std::pair<ICFGRule *, TokenIterator>>
+TokenInput::resolve(const std::vector<std::pair<ICFGRule *, Mark>> &Rules) {
+  std::vector<std::pair<ICFGRule *, TokenIterator>> ResolvedRules;
+  ResolvedRules.reserve(Rules.size());
+  if (!Stream) {
+    for (auto &[Rule, Marked] : Rules) {
+      ResolvedRules.emplace_back(Rule, Marked.ItToken);
+    }
+    return ResolvedRules;
+  }
+  // Tokens are copied first, so that iterators to them stay valid. Marks at
+  // the end of input resolve to the end of the copies.
+  Resolved.clear();
+  for (auto &[Rule, Marked] : Rules) {
+    if (Marked.Tok) {
+      Resolved.push_back(*Marked.Tok);
+    }
+  }
+  auto ItResolved = Resolved.cbegin();
+  for (auto &[Rule, Marked] : Rules) {
+    ResolvedRules.emplace_back(Rule, Marked.Tok ? ItResolved++
+                                                : Resolved.cend());
+  }
+  return ResolvedRules;
+}
+
+void TokenInput::setFoundToken(CFGParserError &Error) {
+  if (!Stream) {
+    Error.EOFFound = ItInput == ItEnd;
+    Error.ItFoundToken = Error.EOFFound ? std::prev(ItInput) : ItInput;
+    return;
+  }
+  auto *Next = Stream->peek();
+  Error.EOFFound = !Next;
+  assert((Next || Latest) && "Input should have at least one token");
+  Resolved.assign(1, Next ? *Next : *Latest);
+  Error.ItFoundToken = Resolved.cbegin();
+}
+
+ParserNodePool::ParserNodePool() { clear(); }
+
+uint32_t ParserNodePool::pushSymbol(Symbol Sym, ICFGRule *Owner,
+                                    uint32_t Next) {
+  assert(Symbols.size() < std::numeric_limits<uint32_t>::max() &&
+         "Too many symbol cells");
+  Symbols.push_back(SymbolCell{Sym, Owner, Next});
+  return static_cast<uint32_t>(Symbols.size() - 1);
+}
+
+uint32_t ParserNodePool::pushTrace(ICFGRule *Rule, TokenIterator ItToken,
+                                   uint32_t Previous) {
+  assert(Traces.size() < std::numeric_limits<uint32_t>::max() &&
+         "Too many trace cells");
+  Traces.push_back(TraceCell{Rule, ItToken, Previous});
+  return static_cast<uint32_t>(Traces.size() - 1);
+}
+
+ParserNodePool::Mark ParserNodePool::getMark() const noexcept {
+  return Mark{static_cast<uint32_t>(Symbols.size()),
+              static_cast<uint32_t>(Traces.size())};
+}
+
+void ParserNodePool::release(Mark PoolMark) {
+  assert(PoolMark.SymbolsNumber <= Symbols.size() &&
+         PoolMark.TracesNumber <= Traces.size() &&
+         "Cells are already released");
+  Symbols.resize(PoolMark.SymbolsNumber, Symbols.front());
+  Traces.resize(PoolMark.TracesNumber, Traces.front());
+}
+
+const ParserNodePool::SymbolCell &
+ParserNodePool::getSymbol(uint32_t Cell) const {
+  assert(Cell != Nil && Cell < Symbols.size() && "Invalid symbol cell");
+  return Symbols[Cell];
+}
+
+const ParserNodePool::TraceCell &ParserNodePool::getTrace(uint32_t Cell) const {
+  assert(Cell != Nil && Cell < Traces.size() && "Invalid trace cell");
+  return Traces[Cell];
+}
+
+void ParserNodePool::clear() {
+  Symbols.assign(1, SymbolCell{Symbol(), nullptr, Nil});
+  Traces.assign(1, TraceCell{nullptr, TokenIterator(), Nil});
+}
+
+PackratMemo::PackratMemo(TokenIterator ItInputBegin, size_t RecordsLimit)
+    : ItBegin(ItInputBegin), Limit(RecordsLimit) {}
+
+const std::vector<PackratMemo::DerivationEnd> *
+PackratMemo::lookup(Symbol NonTerminal, TokenIterator ItInput) {
+  auto It = Derivations.find(getKey(NonTerminal, ItInput));
+  if (It == Derivations.end() || !It->second) {
+    ++Stats.Misses;
+    return nullptr;
+  }
+  ++Stats.Hits;
+  return &*It->second;
+}
+
+void PackratMemo::beginDerivations(Symbol NonTerminal, TokenIterator ItInput,
+                                   uint32_t Below, uint32_t TraceBottom,
+                                   size_t LeavesNumber) {
+  uint64_t Key = getKey(NonTerminal, ItInput);
+  // Derivations which are being recorded may be reached again by left
+  // recursion or through nullable nonterminals. They are just expanded.
+  if (!Recording || !Derivations.emplace(Key, std::nullopt).second) {
+    return;
+  }
+  ++Stats.Records;
+  if (Below >= OpenByBelow.size()) {
+    OpenByBelow.resize(Below + 1, NoDerivation);
+  }
+  Open.push_back(OpenDerivation{Key, Below, TraceBottom, LeavesNumber,
+                                OpenByBelow[Below], {}});
+  OpenByBelow[Below] = Open.size() - 1;
+}
+
+void PackratMemo::finishDerivations(size_t LeavesNumber) {
+  while (!Open.empty() && Open.back().LeavesNumber >= LeavesNumber) {
+    auto &Derivation = Open.back();
+    OpenByBelow[Derivation.Below] = Derivation.PreviousWithSameBelow;
+    Derivations[Derivation.Key] = std::move(Derivation.Ends);
+    Open.pop_back();
+  }
+}
+
+void PackratMemo::checkLimit(size_t PoolCells) {
+  if (!Recording || Stats.Records + PoolCells <= Limit) {
+    return;
+  }
+  Recording = false;
+  decltype(Derivations)().swap(Derivations);
+  decltype(Open)().swap(Open);
+  decltype(OpenByBelow)().swap(OpenByBelow);
+}
+
+bool PackratMemo::isRecording() const noexcept { return Recording; }
+
+bool PackratMemo::isDerivationEnd(uint32_t SymbolCell) const noexcept {
+  return SymbolCell < OpenByBelow.size() &&
+         OpenByBelow[SymbolCell] != NoDerivation;
+}
+
+void PackratMemo::addDerivationEnd(uint32_t SymbolCell, TokenIterator ItInput,
+                                   uint32_t TraceTop,
+                                   ICFGRule *LatestUsedRule) {
+  // Derivations with the same end may differ, but the first one found is
+  // enough: the rest of the parsing tree is the same for all of them.
+  for (size_t I = OpenByBelow[SymbolCell]; I != NoDerivation;
+       I = Open[I].PreviousWithSameBelow) {
+    auto &Ends = Open[I].Ends;
+    if (std::none_of(Ends.begin(), Ends.end(),
+                     [ItInput](const DerivationEnd &End) {
+                       return End.ItInput == ItInput;
+                     })) {
+      Ends.push_back(DerivationEnd{ItInput, TraceTop, Open[I].TraceBottom,
+                                   LatestUsedRule});
+      ++Stats.Records;
+    }
+  }
+}
+
+const CFGParserMemoStats &PackratMemo::getStats() const noexcept {
+  return Stats;
+}
+
+uint64_t PackratMemo::getKey(Symbol NonTerminal, TokenIterator ItInput) const {
+  return static_cast<uint64_t>(NonTerminal.getID()) << 32 |
+         static_cast<uint64_t>(ItInput - ItBegin);
+}
+
+ParserNode::ParserNode(ParserNodePool &NodePool, PackratMemo *DerivationsMemo,
+                       Symbol StartSymbol, TokenIterator ItInputBegin,
+                       TokenIterator ItInputEnd)
+    : Pool(&NodePool), Memo(DerivationsMemo), ItInput(ItInputBegin),
+      ItEnd(ItInputEnd),
+      SymbolTop(NodePool.pushSymbol(StartSymbol, nullptr,
+                                    ParserNodePool::Nil)),
+      TraceTop(ParserNodePool::Nil), LatestUsedRule(nullptr),
+      PoolMark(NodePool.getMark()) {}
+
 bool ParserNode::parseFrontTerminals() {
-  assert(!SymbolStack.empty() && "Parsing is already completed");
-  for (; ItInput != ItEnd && !SymbolStack.empty() &&
-         SymbolStack.top().isTerminal();
-       ++ItInput) {
-    if (SymbolStack.top().getID() != ItInput->getID()) {
+  while (ItInput != ItEnd && !checkStackEmpty() &&
+         getTopSymbol().isTerminal()) {
+    if (getTopSymbol().getID() != ItInput->getID()) {
       return false;
     }
-    SymbolStack.pop();
-    updateRuleStack();
+    ++ItInput;
+    popSymbol();
+    checkDerivationEnd();
   }
   return checkInputEmpty() && checkStackEmpty() ||
          !checkInputEmpty() && !checkStackEmpty();
@@ -249,37 +1116,36 @@ bool ParserNode::isSuccessful() const noexcept {
 }
 
 bool ParserNode::checkStackEmpty() const noexcept {
-  return SymbolStack.empty();
+  return SymbolTop == ParserNodePool::Nil;
 }
 
 bool ParserNode::checkInputEmpty() const noexcept { return ItInput == ItEnd; }
 
-void ParserNode::updateRuleStack() {
-  assert(!RuleStack.empty() && "RuleStack shouldn't be empty");
-  assert(RuleStack.top().second != 0 && "Rule is already applied");
-  --RuleStack.top().second;
-  LatestUsedRule = RuleStack.top().first;
-  if (RuleStack.top().second == 0) {
-    RuleStack.pop();
+void ParserNode::checkDerivationEnd() {
+  if (Memo && Memo->isDerivationEnd(SymbolTop)) {
+    Memo->addDerivationEnd(SymbolTop, ItInput, TraceTop, LatestUsedRule);
   }
 }
 
+void ParserNode::popSymbol() {
+  auto &Cell = Pool->getSymbol(SymbolTop);
+  LatestUsedRule = Cell.Owner;
+  SymbolTop = Cell.Next;
+}
+
 Symbol ParserNode::getTopSymbol() const {
-  assert(!SymbolStack.empty() && "Parsing is already completed");
-  return SymbolStack.top();
+  assert(!checkStackEmpty() && "Parsing is already completed");
+  return Pool->getSymbol(SymbolTop).Sym;
 }
 
 Symbol ParserNode::getTopNonTerminal() const {
-  assert(!SymbolStack.empty() && "Parsing is already completed");
-  assert(SymbolStack.top().isNonTerminal() &&
-         "Top Symbol should be nonterminal");
-  return SymbolStack.top();
+  assert(getTopSymbol().isNonTerminal() && "Top Symbol should be nonterminal");
+  return getTopSymbol();
 }
 
 Symbol ParserNode::getTopTerminal() const {
-  assert(!SymbolStack.empty() && "Parsing is already completed");
-  assert(SymbolStack.top().isTerminal() && "Top Symbol should be terminal");
-  return SymbolStack.top();
+  assert(getTopSymbol().isTerminal() && "Top Symbol should be terminal");
+  return getTopSymbol();
 }
 
 ICFGRule *ParserNode::getLatestUsedRule() noexcept {
@@ -289,22 +1155,55 @@ ICFGRule *ParserNode::getLatestUsedRule() noexcept {
 
 std::vector<std::pair<ICFGRule *, TokenIterator>>
 ParserNode::getParsingTrace() {
+  std::vector<std::pair<ICFGRule *, TokenIterator>> Trace;
+  for (uint32_t Cell = TraceTop; Cell != ParserNodePool::Nil;
+       Cell = Pool->getTrace(Cell).Previous) {
+    auto &TraceCell = Pool->getTrace(Cell);
+    Trace.push_back(std::make_pair(TraceCell.Rule, TraceCell.ItToken));
+  }
+  std::reverse(Trace.begin(), Trace.end());
   return Trace;
 }
 
-void ParserNode::applyRule(ICFGRule *Rule) {
-  assert(!SymbolStack.empty() && "Parsing is already completed");
-  assert(SymbolStack.top().isNonTerminal() &&
-         "Top Symbol should be nonterminal");
-  SymbolStack.pop();
-  updateRuleStack();
-  Trace.push_back(std::make_pair(Rule, ItInput));
-  auto Products = Rule->getProducts();
-  RuleStack.push(std::make_pair(Rule, Products.size()));
+void ParserNode::applyRule(ICFGRule *Rule, ProductsRange Products) {
+  assert(getTopSymbol().isNonTerminal() && "Top Symbol should be nonterminal");
+  popSymbol();
+  TraceTop = Pool->pushTrace(Rule, ItInput, TraceTop);
   for (auto It = Products.rbegin(), ItEnd = Products.rend(); It != ItEnd;
        ++It) {
-    SymbolStack.push(*It);
+    SymbolTop = Pool->pushSymbol(*It, Rule, SymbolTop);
   }
+  PoolMark = Pool->getMark();
+}
+
+void ParserNode::applyDerivation(
+    const PackratMemo::DerivationEnd &Derivation) {
+  assert(getTopSymbol().isNonTerminal() && "Top Symbol should be nonterminal");
+  std::vector<uint32_t> Steps;
+  for (uint32_t Cell = Derivation.TraceTop; Cell != Derivation.TraceBottom;
+       Cell = Pool->getTrace(Cell).Previous) {
+    Steps.push_back(Cell);
+  }
+  for (auto It = Steps.rbegin(), ItStepsEnd = Steps.rend(); It != ItStepsEnd;
+       ++It) {
+    auto &Step = Pool->getTrace(*It);
+    TraceTop = Pool->pushTrace(Step.Rule, Step.ItToken, TraceTop);
+  }
+  popSymbol();
+  LatestUsedRule = Derivation.LatestUsedRule;
+  ItInput = Derivation.ItInput;
+  PoolMark = Pool->getMark();
 }
 
 TokenIterator ParserNode::getInputIterator() const noexcept { return ItInput; }
+
+uint32_t ParserNode::getSymbolBelowTop() const {
+  assert(!checkStackEmpty() && "Parsing is already completed");
+  return Pool->getSymbol(SymbolTop).Next;
+}
+
+uint32_t ParserNode::getTraceTop() const noexcept { return TraceTop; }
+
+ParserNodePool::Mark ParserNode::getPoolMark() const noexcept {
+  return PoolMark;
+}
@@ -0,0 +1,333 @@
+#include "cowabunga/Parser/EarleyParser.h"
+
+#include "cowabunga/Parser/CFGParserError.h"
+
+#include <algorithm>
+#include <cassert>
+
+using namespace cb;
+
+namespace {
+
+enum TaskKind { TK_Rule, TK_Children, TK_Empty, TK_Leo };
+
+/// Step of rebuilding the derivation. Rules are emitted in reverse preorder
+/// of the derivation tree, so children of every node are visited from right
+/// to left, which is the order item links are stored in.
+struct Task {
+  TaskKind Kind;
+  uint32_t First;
+  uint32_t Second;
+};
+
+} // namespace
+
+EarleyParser::EarleyParser(const GrammarIndex &GrammarRules)
+    : Grammar(GrammarRules), ItInputBegin(), InputLength(0) {
+  // A rule is chosen only when all of its products already have empty
+  // derivations, so the chosen derivations have no cycles.
+  EmptyRules.assign(Grammar.getNonTerminalsNumber(), None);
+  for (bool Changed = true; Changed;) {
+    Changed = false;
+    for (size_t Rule = 0; Rule < Grammar.getRulesNumber(); ++Rule) {
+      int NonTerminalID = Grammar.getNonTerminalID(Rule);
+      if (EmptyRules[NonTerminalID] != None) {
+        continue;
+      }
+      auto Products = Grammar.getProducts(Rule);
+      if (std::all_of(Products.begin(), Products.end(),
+                      [this](const Symbol &Product) {
+                        return Product.isNonTerminal() &&
+                               EmptyRules[Product.getID()] != None;
+                      })) {
+        EmptyRules[NonTerminalID] = static_cast<uint32_t>(Rule);
+        Changed = true;
+      }
+    }
+  }
+  PredictedAt.assign(Grammar.getNonTerminalsNumber(), None);
+}
+
+std::vector<std::pair<ICFGRule *, TokenIterator>>
+EarleyParser::parse(TokenIterator ItBegin, TokenIterator ItEnd) {
+  ItInputBegin = ItBegin;
+  InputLength = static_cast<uint32_t>(ItEnd - ItBegin);
+  for (uint32_t Position = 0; Position <= InputLength; ++Position) {
+    buildSet(Position);
+    if (Position < InputLength && Scanned.empty()) {
+      produceError(Position);
+      return {};
+    }
+  }
+  SetBegins.push_back(static_cast<uint32_t>(Items.size()));
+  uint32_t Accepting = findAcceptingItem();
+  if (Accepting == None) {
+    produceError(InputLength);
+    return {};
+  }
+  return getDerivation(Accepting);
+}
+
+void EarleyParser::buildSet(uint32_t Position) {
+  SetBegins.push_back(static_cast<uint32_t>(Items.size()));
+  SetItems.clear();
+  if (Position == 0) {
+    predict(Grammar.getStartSymbol(), Position);
+  }
+  for (auto &ScannedItem : Scanned) {
+    addItem(ScannedItem);
+  }
+  Scanned.clear();
+  for (uint32_t Index = SetBegins.back(); Index < Items.size(); ++Index) {
+    Item Current = Items[Index];
+    auto Products = Grammar.getProducts(Current.Rule);
+    if (Current.Dot == Products.size()) {
+      // Empty derivations are taken into account when nullable nonterminals
+      // are predicted.
+      if (Current.Origin != Position) {
+        complete(Index);
+      }
+      continue;
+    }
+    auto Next = Products[Current.Dot];
+    if (Next.isTerminal()) {
+      if (Position < InputLength &&
+          ItInputBegin[Position].getID() == Next.getID()) {
+        Scanned.push_back(Item{Current.Rule, Current.Dot + 1, Current.Origin,
+                               Index, None, 0, LK_Terminal});
+      }
+      continue;
+    }
+    predict(Next, Position);
+    if (EmptyRules[Next.getID()] != None) {
+      addItem(Item{Current.Rule, Current.Dot + 1, Current.Origin, Index,
+                   static_cast<uint32_t>(Next.getID()), Position, LK_Empty});
+    }
+  }
+  indexWaitingItems(Position);
+}
+
+void EarleyParser::addItem(const Item &NewItem) {
+  if (SetItems.insert(getItemKey(NewItem)).second) {
+    Items.push_back(NewItem);
+  }
+}
+
+void EarleyParser::predict(Symbol NonTerminal, uint32_t Position) {
+  auto &Predicted = PredictedAt[NonTerminal.getID()];
+  if (Predicted == Position) {
+    return;
+  }
+  Predicted = Position;
+  // Rules are predicted in the order CFGParser tries them.
+  auto [RulesBegin, RulesEnd] = Grammar.getRules(NonTerminal.getID());
+  for (size_t Rule = RulesEnd; Rule-- > RulesBegin;) {
+    addItem(Item{static_cast<uint32_t>(Rule), 0, Position, None, None, 0,
+                 LK_None});
+  }
+}
+
+void EarleyParser::complete(uint32_t Completed) {
+  auto Origin = Items[Completed].Origin;
+  int NonTerminalID = Grammar.getNonTerminalID(Items[Completed].Rule);
+  uint32_t Record = getLeoRecord(Origin, NonTerminalID);
+  if (Record != None) {
+    // Items of the deterministic reduction path would be completed one by
+    // one, only the topmost of them is added instead.
+    uint32_t Top = LeoRecords[Record].Top;
+    addItem(Item{Items[Top].Rule, Items[Top].Dot + 1, Items[Top].Origin, Top,
+                 Completed, Record, LK_Leo});
+    return;
+  }
+  auto [ItBegin, ItEnd] = getWaitingItems(Origin, NonTerminalID);
+  for (auto It = ItBegin; It != ItEnd; ++It) {
+    uint32_t Awaiting = It->second;
+    addItem(Item{Items[Awaiting].Rule, Items[Awaiting].Dot + 1,
+                 Items[Awaiting].Origin, Awaiting, Completed, 0,
+                 LK_Completed});
+  }
+}
+
+uint32_t EarleyParser::getLeoRecord(uint32_t Position, int NonTerminalID) {
+  LeoPath.clear();
+  uint32_t Next = None;
+  while (true) {
+    uint64_t Key = static_cast<uint64_t>(Position) << 32 |
+                   static_cast<uint32_t>(NonTerminalID);
+    auto [ItRecord, Inserted] = LeoRecordsIndex.emplace(Key, None);
+    if (!Inserted) {
+      Next = ItRecord->second;
+      break;
+    }
+    // The whole input may be derived from the start symbol, so its
+    // completion at the beginning is never skipped.
+    if (Position == 0 &&
+        NonTerminalID == Grammar.getStartSymbol().getID()) {
+      break;
+    }
+    auto [ItBegin, ItEnd] = getWaitingItems(Position, NonTerminalID);
+    if (ItEnd - ItBegin != 1) {
+      break;
+    }
+    uint32_t Awaiting = ItBegin->second;
+    auto &Awaited = Items[Awaiting];
+    if (Awaited.Dot + 1 != Grammar.getProducts(Awaited.Rule).size()) {
+      break;
+    }
+    LeoPath.emplace_back(Key, Awaiting);
+    Position = Awaited.Origin;
+    NonTerminalID = Grammar.getNonTerminalID(Awaited.Rule);
+  }
+  for (auto It = LeoPath.rbegin(), ItEnd = LeoPath.rend(); It != ItEnd;
+       ++It) {
+    uint32_t Top = Next == None ? It->second : LeoRecords[Next].Top;
+    LeoRecords.push_back(LeoRecord{It->second, Next, Top});
+    Next = static_cast<uint32_t>(LeoRecords.size() - 1);
+    LeoRecordsIndex[It->first] = Next;
+  }
+  return Next;
+}
+
+std::pair<EarleyParser::WaitingIterator, EarleyParser::WaitingIterator>
+EarleyParser::getWaitingItems(uint32_t Position, int NonTerminalID) const {
+  assert(Position < WaitingBegins.size() && "Set should be indexed");
+  auto ItBegin = Waiting.begin() + WaitingBegins[Position];
+  auto ItEnd = Position + 1 < WaitingBegins.size()
+                   ? Waiting.begin() + WaitingBegins[Position + 1]
+                   : Waiting.end();
+  return std::equal_range(ItBegin, ItEnd,
+                          std::make_pair(NonTerminalID, uint32_t(0)),
+                          [](const std::pair<int, uint32_t> &LHS,
+                             const std::pair<int, uint32_t> &RHS) {
+                            return LHS.first < RHS.first;
+                          });
+}
+
+void EarleyParser::indexWaitingItems(uint32_t Position) {
+  WaitingBegins.push_back(static_cast<uint32_t>(Waiting.size()));
+  for (uint32_t Index = SetBegins[Position]; Index < Items.size(); ++Index) {
+    auto Products = Grammar.getProducts(Items[Index].Rule);
+    if (Items[Index].Dot < Products.size() &&
+        Products[Items[Index].Dot].isNonTerminal()) {
+      Waiting.emplace_back(Products[Items[Index].Dot].getID(), Index);
+    }
+  }
+  std::sort(Waiting.begin() + WaitingBegins.back(), Waiting.end());
+}
+
+uint32_t EarleyParser::findAcceptingItem() const {
+  for (uint32_t Index = SetBegins[InputLength];
+       Index < SetBegins[InputLength + 1]; ++Index) {
+    auto &Current = Items[Index];
+    if (Current.Origin == 0 &&
+        Grammar.getNonTerminalID(Current.Rule) ==
+            Grammar.getStartSymbol().getID() &&
+        Current.Dot == Grammar.getProducts(Current.Rule).size()) {
+      return Index;
+    }
+  }
+  return None;
+}
+
+std::vector<std::pair<ICFGRule *, TokenIterator>>
+EarleyParser::getDerivation(uint32_t Accepting) {
+  std::vector<std::pair<ICFGRule *, TokenIterator>> Trace;
+  std::vector<Task> Tasks{{TK_Rule, Items[Accepting].Rule,
+                           Items[Accepting].Origin},
+                          {TK_Children, Accepting, 0}};
+  std::vector<uint32_t> Chain;
+  while (!Tasks.empty()) {
+    auto Current = Tasks.back();
+    Tasks.pop_back();
+    switch (Current.Kind) {
+    case TK_Rule:
+      Trace.emplace_back(Grammar.getRule(Current.First),
+                         ItInputBegin + Current.Second);
+      break;
+    case TK_Children: {
+      auto &Parent = Items[Current.First];
+      if (Parent.Kind == LK_None) {
+        break;
+      }
+      Tasks.push_back(Task{TK_Children, Parent.Previous, 0});
+      if (Parent.Kind == LK_Completed) {
+        auto &Child = Items[Parent.Child];
+        Tasks.push_back(Task{TK_Rule, Child.Rule, Child.Origin});
+        Tasks.push_back(Task{TK_Children, Parent.Child, 0});
+      } else if (Parent.Kind == LK_Empty) {
+        Tasks.push_back(Task{TK_Empty, Parent.Child, Parent.Aux});
+      } else if (Parent.Kind == LK_Leo) {
+        Tasks.push_back(Task{TK_Leo, Current.First, 0});
+      }
+      break;
+    }
+    case TK_Empty: {
+      uint32_t Rule = EmptyRules[Current.First];
+      Tasks.push_back(Task{TK_Rule, Rule, Current.Second});
+      for (auto &Product : Grammar.getProducts(Rule)) {
+        Tasks.push_back(Task{TK_Empty, static_cast<uint32_t>(Product.getID()),
+                             Current.Second});
+      }
+      break;
+    }
+    case TK_Leo: {
+      // Every record but the last one stands for a completed item which has
+      // been skipped. Its last symbol is derived by the previous record, and
+      // the first one's is derived by the item which has been completed.
+      auto &Top = Items[Current.First];
+      Chain.clear();
+      for (uint32_t Record = Top.Aux; LeoRecords[Record].Next != None;
+           Record = LeoRecords[Record].Next) {
+        Chain.push_back(LeoRecords[Record].Awaiting);
+      }
+      for (auto It = Chain.rbegin(), ItEnd = Chain.rend(); It != ItEnd; ++It) {
+        Tasks.push_back(Task{TK_Rule, Items[*It].Rule, Items[*It].Origin});
+        Tasks.push_back(Task{TK_Children, *It, 0});
+      }
+      auto &Bottom = Items[Top.Child];
+      Tasks.push_back(Task{TK_Rule, Bottom.Rule, Bottom.Origin});
+      Tasks.push_back(Task{TK_Children, Top.Child, 0});
+      break;
+    }
+    }
+  }
+  std::reverse(Trace.begin(), Trace.end());
+  return Trace;
+}
+
+void EarleyParser::produceError(uint32_t Position) {
+  CFGParserError Error;
+  Error.EOFFound = Position == InputLength;
+  Error.ItFoundToken = ItInputBegin + Position;
+  if (Error.EOFFound) {
+    --Error.ItFoundToken;
+  }
+  Error.EOFExpected = true;
+  Error.FailedRule = nullptr;
+  uint32_t SetEnd = Position + 1 < SetBegins.size()
+                        ? SetBegins[Position + 1]
+                        : static_cast<uint32_t>(Items.size());
+  for (uint32_t Index = SetBegins[Position]; Index < SetEnd; ++Index) {
+    auto &Current = Items[Index];
+    auto Products = Grammar.getProducts(Current.Rule);
+    if (Current.Dot < Products.size() && Products[Current.Dot].isTerminal()) {
+      Error.EOFExpected = false;
+      Error.ExpectedSymbol = Products[Current.Dot];
+      Error.FailedRule = Grammar.getRule(Current.Rule);
+      break;
+    }
+  }
+  if (!Error.FailedRule) {
+    auto [RulesBegin, RulesEnd] =
+        Grammar.getRules(Grammar.getStartSymbol().getID());
+    Error.FailedRule = Grammar.getRule(RulesBegin != RulesEnd ? RulesBegin : 0);
+  }
+  Error.FailedRule->produceError(Error);
+}
+
+uint64_t EarleyParser::getItemKey(const Item &It) const noexcept {
+  // Dotted rules of rule I are numbered from the offset of its products
+  // plus I, so that every rule has one more of them than products.
+  uint64_t DottedRule = Grammar.getProductsOffset(It.Rule) + It.Rule + It.Dot;
+  return DottedRule << 32 | It.Origin;
+}
@@ -0,0 +1,254 @@
+#include "cowabunga/Parser/GrammarAnalysis.h"
+
+#include <algorithm>
+
+using namespace cb;
+
+GrammarAnalysis::GrammarAnalysis(const GrammarIndex &Grammar) {
+  LL1Table First(Grammar);
+  findUselessNonTerminals(Grammar);
+  findLeftRecursion(Grammar, First);
+  classifyConflicts(Grammar, First);
+  LALRConflicts = LALRTable(Grammar).getConflicts();
+  findAmbiguity(Grammar, First);
+}
+
+GrammarComplexity
+GrammarAnalysis::getComplexity(CFGParserAlgorithm Algorithm,
+                               bool Compiled) const noexcept {
+  if (Compiled && isLL1()) {
+    return GrammarComplexity::Linear;
+  }
+  switch (Algorithm) {
+  case CFGParserAlgorithm::Earley:
+    // Leo's items make Earley parsing linear on LR(k) grammars, which LL(1)
+    // and LALR(1) grammars are.
+    if (isLL1() || isLALR1()) {
+      return GrammarComplexity::Linear;
+    }
+    return GrammarComplexity::Cubic;
+  case CFGParserAlgorithm::LALR:
+    if (isLALR1()) {
+      return GrammarComplexity::Linear;
+    }
+    break;
+  case CFGParserAlgorithm::Backtracking:
+    break;
+  }
+  return LoopsOnLeftRecursion ? GrammarComplexity::NonTerminating
+                              : GrammarComplexity::Exponential;
+}
+
+void GrammarAnalysis::findUselessNonTerminals(const GrammarIndex &Grammar) {
+  size_t NonTerminalsNumber = Grammar.getNonTerminalsNumber();
+  Used.assign(NonTerminalsNumber, false);
+  Used[Grammar.getStartSymbol().getID()] = true;
+  for (size_t I = 0; I < Grammar.getRulesNumber(); ++I) {
+    Used[Grammar.getNonTerminalID(I)] = true;
+    for (auto &Product : Grammar.getProducts(I)) {
+      if (Product.isNonTerminal()) {
+        Used[Product.getID()] = true;
+      }
+    }
+  }
+
+  Productive.assign(NonTerminalsNumber, false);
+  for (bool Changed = true; Changed;) {
+    Changed = false;
+    for (size_t I = 0; I < Grammar.getRulesNumber(); ++I) {
+      if (Productive[Grammar.getNonTerminalID(I)]) {
+        continue;
+      }
+      auto Products = Grammar.getProducts(I);
+      if (std::all_of(Products.begin(), Products.end(),
+                      [this](const Symbol &Product) {
+                        return Product.isTerminal() ||
+                               Productive[Product.getID()];
+                      })) {
+        Productive[Grammar.getNonTerminalID(I)] = true;
+        Changed = true;
+      }
+    }
+  }
+
+  Reachable.assign(NonTerminalsNumber, false);
+  std::vector<int> Pending{Grammar.getStartSymbol().getID()};
+  Reachable[Pending.back()] = true;
+  while (!Pending.empty()) {
+    auto [RulesBegin, RulesEnd] = Grammar.getRules(Pending.back());
+    Pending.pop_back();
+    for (size_t I = RulesBegin; I < RulesEnd; ++I) {
+      for (auto &Product : Grammar.getProducts(I)) {
+        if (Product.isNonTerminal() && !Reachable[Product.getID()]) {
+          Reachable[Product.getID()] = true;
+          Pending.push_back(Product.getID());
+        }
+      }
+    }
+  }
+
+  for (size_t I = 0; I < NonTerminalsNumber; ++I) {
+    if (!Used[I]) {
+      continue;
+    }
+    if (!Reachable[I]) {
+      Unreachable.push_back(nonTerminal(static_cast<int>(I)));
+    }
+    if (!Productive[I]) {
+      NonProductive.push_back(nonTerminal(static_cast<int>(I)));
+    }
+  }
+}
+
+void GrammarAnalysis::findLeftRecursion(const GrammarIndex &Grammar,
+                                        const LL1Table &First) {
+  std::vector<std::vector<int>> LeftCorners(Grammar.getNonTerminalsNumber());
+  for (size_t I = 0; I < Grammar.getRulesNumber(); ++I) {
+    auto Products = Grammar.getProducts(I);
+    for (size_t J = 0; J < Products.size() && Products[J].isNonTerminal();
+         ++J) {
+      LeftCorners[Grammar.getNonTerminalID(I)].push_back(Products[J].getID());
+      if (!First.isNullable(Products[J].getID())) {
+        break;
+      }
+    }
+  }
+  auto OnCycle = findCycles(LeftCorners);
+  for (size_t I = 0; I < OnCycle.size(); ++I) {
+    if (OnCycle[I]) {
+      LeftRecursive.push_back(nonTerminal(static_cast<int>(I)));
+      LoopsOnLeftRecursion |= Reachable[I];
+    }
+  }
+}
+
+void GrammarAnalysis::classifyConflicts(const GrammarIndex &Grammar,
+                                        const LL1Table &First) {
+  for (auto &Conflict : First.getConflicts()) {
+    size_t Column = Conflict.Lookahead + 1;
+    size_t Starting = 0;
+    auto [RulesBegin, RulesEnd] =
+        Grammar.getRules(Conflict.NonTerminal.getID());
+    for (size_t I = RulesBegin; I < RulesEnd; ++I) {
+      if (std::find(Conflict.Rules.begin(), Conflict.Rules.end(),
+                    Grammar.getRule(I)) == Conflict.Rules.end()) {
+        continue;
+      }
+      std::vector<bool> RuleFirst(Grammar.getTerminalsNumber() + 1);
+      First.addFirst(Grammar.getProducts(I), 0, RuleFirst);
+      Starting += RuleFirst[Column];
+    }
+    if (Starting > 1) {
+      FirstFirstConflicts.push_back(Conflict);
+    } else {
+      FirstFollowConflicts.push_back(Conflict);
+    }
+  }
+}
+
+void GrammarAnalysis::findAmbiguity(const GrammarIndex &Grammar,
+                                    const LL1Table &First) {
+  if (isLL1() || isLALR1()) {
+    Ambiguity = GrammarAmbiguity::Unambiguous;
+    return;
+  }
+  // A nonterminal takes part in a derivation of some input if it is reached
+  // from the start symbol through rules of productive symbols only.
+  auto IsProductiveRule = [&](size_t Rule) {
+    auto Products = Grammar.getProducts(Rule);
+    return std::all_of(Products.begin(), Products.end(),
+                       [this](const Symbol &Product) {
+                         return Product.isTerminal() ||
+                                Productive[Product.getID()];
+                       });
+  };
+  std::vector<bool> Useful(Grammar.getNonTerminalsNumber(), false);
+  std::vector<int> Pending;
+  if (Productive[Grammar.getStartSymbol().getID()]) {
+    Pending.push_back(Grammar.getStartSymbol().getID());
+    Useful[Pending.back()] = true;
+  }
+  while (!Pending.empty()) {
+    auto [RulesBegin, RulesEnd] = Grammar.getRules(Pending.back());
+    Pending.pop_back();
+    for (size_t I = RulesBegin; I < RulesEnd; ++I) {
+      if (!IsProductiveRule(I)) {
+        continue;
+      }
+      for (auto &Product : Grammar.getProducts(I)) {
+        if (Product.isNonTerminal() && !Useful[Product.getID()]) {
+          Useful[Product.getID()] = true;
+          Pending.push_back(Product.getID());
+        }
+      }
+    }
+  }
+
+  std::vector<std::vector<int>> UnitDerivations(Useful.size());
+  for (size_t NonTerminal = 0; NonTerminal < Useful.size(); ++NonTerminal) {
+    if (!Useful[NonTerminal]) {
+      continue;
+    }
+    auto [RulesBegin, RulesEnd] =
+        Grammar.getRules(static_cast<int>(NonTerminal));
+    for (size_t I = RulesBegin; I < RulesEnd; ++I) {
+      if (!IsProductiveRule(I)) {
+        continue;
+      }
+      auto Products = Grammar.getProducts(I);
+      bool Empty = isNullable(First, Products, 0, Products.size());
+      for (size_t J = I + 1; J < RulesEnd; ++J) {
+        auto Other = Grammar.getProducts(J);
+        if ((Empty && isNullable(First, Other, 0, Other.size())) ||
+            std::equal(Products.begin(), Products.end(), Other.begin(),
+                       Other.end())) {
+          Ambiguity = GrammarAmbiguity::Ambiguous;
+          return;
+        }
+      }
+      for (size_t J = 0; J < Products.size(); ++J) {
+        if (Products[J].isNonTerminal() &&
+            isNullable(First, Products, 0, J) &&
+            isNullable(First, Products, J + 1, Products.size())) {
+          UnitDerivations[NonTerminal].push_back(Products[J].getID());
+        }
+      }
+    }
+  }
+  auto OnCycle = findCycles(UnitDerivations);
+  if (std::find(OnCycle.begin(), OnCycle.end(), true) != OnCycle.end()) {
+    Ambiguity = GrammarAmbiguity::Ambiguous;
+  }
+}
+
+bool GrammarAnalysis::isNullable(const LL1Table &First, ProductsRange Products,
+                                 size_t Begin, size_t End) {
+  for (size_t I = Begin; I < End; ++I) {
+    if (Products[I].isTerminal() || !First.isNullable(Products[I].getID())) {
+      return false;
+    }
+  }
+  return true;
+}
+
+std::vector<bool>
+GrammarAnalysis::findCycles(const std::vector<std::vector<int>> &Edges) {
+  std::vector<bool> OnCycle(Edges.size(), false);
+  std::vector<bool> Visited;
+  std::vector<int> Pending;
+  for (size_t From = 0; From < Edges.size(); ++From) {
+    Visited.assign(Edges.size(), false);
+    Pending.assign(Edges[From].begin(), Edges[From].end());
+    while (!Pending.empty() && !OnCycle[From]) {
+      int To = Pending.back();
+      Pending.pop_back();
+      if (Visited[To]) {
+        continue;
+      }
+      Visited[To] = true;
+      OnCycle[From] = static_cast<size_t>(To) == From;
+      Pending.insert(Pending.end(), Edges[To].begin(), Edges[To].end());
+    }
+  }
+  return OnCycle;
+}
@@ -0,0 +1,41 @@
+#include "cowabunga/Parser/GrammarIndex.h"
+
+#include <algorithm>
+#include <cassert>
+
+using namespace cb;
+
+GrammarIndex::GrammarIndex(Symbol StartSymbol,
+                           const std::vector<std::unique_ptr<ICFGRule>> &Rules)
+    : Start(StartSymbol), TerminalsNumber(0) {
+  assert(Start.isNonTerminal() && "Start symbol should be nonterminal");
+  int MaxNonTerminalID = Start.getID();
+  ProductOffsets.push_back(0);
+  for (auto &Rule : Rules) {
+    RulePointers.push_back(Rule.get());
+    RuleNonTerminals.push_back(Rule->getLHSNonTerminal().getID());
+    assert(RuleNonTerminals.back() >= 0 && "Symbol IDs should be non-negative");
+    assert((RuleNonTerminals.size() == 1 ||
+            RuleNonTerminals.end()[-2] <= RuleNonTerminals.back()) &&
+           "Rules should be sorted by nonterminals");
+    MaxNonTerminalID = std::max(MaxNonTerminalID, RuleNonTerminals.back());
+    for (auto &Product : Rule->getProducts()) {
+      assert(Product.getID() >= 0 && "Symbol IDs should be non-negative");
+      if (Product.isTerminal()) {
+        TerminalsNumber = std::max(TerminalsNumber,
+                                   static_cast<size_t>(Product.getID()) + 1);
+      } else {
+        MaxNonTerminalID = std::max(MaxNonTerminalID, Product.getID());
+      }
+      Products.push_back(Product);
+    }
+    ProductOffsets.push_back(static_cast<uint32_t>(Products.size()));
+  }
+  RuleOffsets.assign(MaxNonTerminalID + 2, 0);
+  for (int NonTerminalID : RuleNonTerminals) {
+    ++RuleOffsets[NonTerminalID + 1];
+  }
+  for (size_t I = 1; I < RuleOffsets.size(); ++I) {
+    RuleOffsets[I] += RuleOffsets[I - 1];
+  }
+}
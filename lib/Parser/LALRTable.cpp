@@ -0,0 +1,375 @@
+#include "cowabunga/Parser/LALRTable.h"
+
+#include <algorithm>
+#include <cassert>
+#include <map>
+
+using namespace cb;
+
+namespace {
+
+/// Adds elements of From to To. Returns true if To has changed.
+bool mergeSets(std::vector<bool> &To, const std::vector<bool> &From) {
+  bool Changed = false;
+  for (size_t I = 0; I < From.size() && I < To.size(); ++I) {
+    if (From[I] && !To[I]) {
+      To[I] = true;
+      Changed = true;
+    }
+  }
+  return Changed;
+}
+
+int32_t encodeSymbol(const Symbol &Sym) {
+  return Sym.isTerminal() ? Sym.getID() : -Sym.getID() - 1;
+}
+
+template <class T>
+void writeArray(std::ostream &OS, const char *Type, const std::string &Name,
+                const std::vector<T> &Values) {
+  OS << "constexpr " << Type << " " << Name << "[] = {";
+  // Arrays can't be empty, and sizes of the tables are kept apart anyway.
+  if (Values.empty()) {
+    OS << "0};\n\n";
+    return;
+  }
+  size_t LineLength = 80;
+  for (size_t I = 0; I < Values.size(); ++I) {
+    std::string Value = std::to_string(Values[I]);
+    if (I + 1 < Values.size()) {
+      Value += ",";
+    }
+    if (LineLength + Value.size() + 1 > 80) {
+      OS << "\n   ";
+      LineLength = 3;
+    }
+    OS << " " << Value;
+    LineLength += Value.size() + 1;
+  }
+  OS << "};\n\n";
+}
+
+} // namespace
+
+LALRTable::LALRTable(const GrammarIndex &GrammarRules)
+    : Grammar(GrammarRules), ColumnsNumber(Grammar.getTerminalsNumber() + 1),
+      NonTerminalsNumber(Grammar.getNonTerminalsNumber()),
+      AugmentedRule(static_cast<uint32_t>(Grammar.getRulesNumber())),
+      AugmentedProducts{Grammar.getStartSymbol()}, Data() {
+  LL1Table First(Grammar);
+  buildStates();
+  computeLookaheads(First);
+  buildActions(First);
+  fillData();
+}
+
+bool LALRTable::matches(const LALRTableData &Data,
+                        const GrammarIndex &Grammar) {
+  if (Data.StartNonTerminal != Grammar.getStartSymbol().getID() ||
+      Data.ColumnsNumber != Grammar.getTerminalsNumber() + 1 ||
+      Data.NonTerminalsNumber != Grammar.getNonTerminalsNumber() ||
+      Data.RulesNumber != Grammar.getRulesNumber()) {
+    return false;
+  }
+  for (size_t Rule = 0; Rule < Grammar.getRulesNumber(); ++Rule) {
+    auto Products = Grammar.getProducts(Rule);
+    const int32_t *ItProduct = Data.Products + Data.ProductOffsets[Rule];
+    if (Data.RuleNonTerminals[Rule] != Grammar.getNonTerminalID(Rule) ||
+        Data.ProductOffsets[Rule + 1] - Data.ProductOffsets[Rule] !=
+            Products.size() ||
+        !std::equal(Products.begin(), Products.end(), ItProduct,
+                    [](const Symbol &Product, int32_t Encoded) {
+                      return encodeSymbol(Product) == Encoded;
+                    })) {
+      return false;
+    }
+  }
+  return true;
+}
+
+const std::vector<LALRConflict> &LALRTable::getConflicts() const noexcept {
+  return Conflicts;
+}
+
+void LALRTable::writeHeader(std::ostream &OS, const std::string &Name) const {
+  OS << "// LALR(1) tables of a grammar with " << Data.RulesNumber
+     << " rules and " << Data.StatesNumber << " states.\n"
+     << "// Generated by cb::LALRTable::writeHeader, do not edit.\n\n"
+     << "#include \"cowabunga/Parser/LALRTable.h\"\n\n"
+     << "#include <cstdint>\n\n";
+  writeArray(OS, "uint32_t", Name + "Actions", Actions);
+  writeArray(OS, "uint32_t", Name + "Gotos", Gotos);
+  writeArray(OS, "uint32_t", Name + "StateRules", StateRules);
+  writeArray(OS, "int32_t", Name + "RuleNonTerminals", RuleNonTerminals);
+  writeArray(OS, "uint32_t", Name + "ProductOffsets", ProductOffsets);
+  writeArray(OS, "int32_t", Name + "Products", Products);
+  OS << "constexpr cb::LALRTableData " << Name << " = {\n"
+     << "    " << Data.StartNonTerminal << ", " << Data.StatesNumber << ", "
+     << Data.ColumnsNumber << ", " << Data.NonTerminalsNumber << ", "
+     << Data.RulesNumber << ", " << Data.ConflictsNumber << ",\n";
+  for (const char *Array : {"Actions", "Gotos", "StateRules",
+                            "RuleNonTerminals", "ProductOffsets"}) {
+    OS << "    " << Name << Array << ",\n";
+  }
+  OS << "    " << Name << "Products};\n";
+}
+
+void LALRTable::buildStates() {
+  std::map<std::vector<Item>, uint32_t> States;
+  std::vector<Item> Kernel{Item{AugmentedRule, 0}};
+  States.emplace(Kernel, 0);
+  KernelItems = Kernel;
+  KernelOffsets = {0, 1};
+  // Kernels of successors are collected in slots of their symbols: columns
+  // of terminals go first, then nonterminals.
+  std::vector<uint32_t> Slots(ColumnsNumber + NonTerminalsNumber, None);
+  std::vector<std::pair<size_t, std::vector<Item>>> Successors;
+  std::vector<Item> Closure;
+  std::vector<bool> Predicted;
+  for (uint32_t State = 0; State + 1 < KernelOffsets.size(); ++State) {
+    Actions.resize(Actions.size() + ColumnsNumber, AK_Error);
+    Gotos.resize(Gotos.size() + NonTerminalsNumber, 0);
+    Closure.assign(KernelItems.begin() + KernelOffsets[State],
+                   KernelItems.begin() + KernelOffsets[State + 1]);
+    Predicted.assign(NonTerminalsNumber, false);
+    Successors.clear();
+    for (size_t I = 0; I < Closure.size(); ++I) {
+      auto Current = Closure[I];
+      auto Products = getProducts(Current.Rule);
+      if (Current.Dot == Products.size()) {
+        continue;
+      }
+      auto Next = Products[Current.Dot];
+      size_t Slot = Next.isTerminal() ? Next.getID() + 1
+                                      : ColumnsNumber + Next.getID();
+      if (Slots[Slot] == None) {
+        Slots[Slot] = static_cast<uint32_t>(Successors.size());
+        Successors.emplace_back(Slot, std::vector<Item>());
+      }
+      Successors[Slots[Slot]].second.push_back(
+          Item{Current.Rule, Current.Dot + 1});
+      if (Next.isTerminal() || Predicted[Next.getID()]) {
+        continue;
+      }
+      Predicted[Next.getID()] = true;
+      auto [RulesBegin, RulesEnd] = Grammar.getRules(Next.getID());
+      for (size_t Rule = RulesBegin; Rule < RulesEnd; ++Rule) {
+        Closure.push_back(Item{static_cast<uint32_t>(Rule), 0});
+      }
+    }
+    for (auto &[Slot, NextKernel] : Successors) {
+      Slots[Slot] = None;
+      std::sort(NextKernel.begin(), NextKernel.end());
+      auto [ItState, Inserted] = States.emplace(
+          NextKernel, static_cast<uint32_t>(KernelOffsets.size() - 1));
+      if (Inserted) {
+        KernelItems.insert(KernelItems.end(), NextKernel.begin(),
+                           NextKernel.end());
+        KernelOffsets.push_back(static_cast<uint32_t>(KernelItems.size()));
+      }
+      if (Slot < ColumnsNumber) {
+        Actions[State * ColumnsNumber + Slot] =
+            ItState->second << 2 | AK_Shift;
+      } else {
+        Gotos[State * NonTerminalsNumber + Slot - ColumnsNumber] =
+            ItState->second;
+      }
+    }
+  }
+}
+
+void LALRTable::computeLookaheads(const LL1Table &First) {
+  KernelLookaheads.assign(KernelItems.size(),
+                          std::vector<bool>(ColumnsNumber));
+  // The augmented rule is followed by the end of input.
+  KernelLookaheads[0][0] = true;
+  std::vector<std::vector<uint32_t>> Propagations(KernelItems.size());
+  for (uint32_t State = 0; State + 1 < KernelOffsets.size(); ++State) {
+    for (uint32_t Kernel = KernelOffsets[State];
+         Kernel < KernelOffsets[State + 1]; ++Kernel) {
+      std::vector<LookaheadItem> Closure{
+          LookaheadItem{KernelItems[Kernel],
+                        std::vector<bool>(ColumnsNumber + 1)}};
+      Closure.front().Lookaheads.back() = true;
+      Closure = getClosure(First, std::move(Closure));
+      for (auto &Current : Closure) {
+        if (Current.Dotted.Dot == getProducts(Current.Dotted.Rule).size()) {
+          continue;
+        }
+        uint32_t Next = getNextKernelItem(State, Current.Dotted);
+        mergeSets(KernelLookaheads[Next], Current.Lookaheads);
+        if (Current.Lookaheads.back()) {
+          Propagations[Kernel].push_back(Next);
+        }
+      }
+    }
+  }
+  for (bool Changed = true; Changed;) {
+    Changed = false;
+    for (size_t Kernel = 0; Kernel < KernelItems.size(); ++Kernel) {
+      for (uint32_t Next : Propagations[Kernel]) {
+        Changed |= mergeSets(KernelLookaheads[Next], KernelLookaheads[Kernel]);
+      }
+    }
+  }
+}
+
+void LALRTable::buildActions(const LL1Table &First) {
+  uint32_t StatesNumber = static_cast<uint32_t>(KernelOffsets.size() - 1);
+  StateRules.assign(StatesNumber, 0);
+  for (uint32_t State = 0; State < StatesNumber; ++State) {
+    std::vector<LookaheadItem> Closure;
+    for (uint32_t Kernel = KernelOffsets[State];
+         Kernel < KernelOffsets[State + 1]; ++Kernel) {
+      Closure.push_back(
+          LookaheadItem{KernelItems[Kernel], KernelLookaheads[Kernel]});
+      Closure.back().Lookaheads.push_back(false);
+    }
+    Closure = getClosure(First, std::move(Closure));
+    // Errors are reported by the first item which expects a token, as
+    // EarleyParser does.
+    auto ItReporting =
+        std::find_if(Closure.begin(), Closure.end(),
+                     [this](const LookaheadItem &Current) {
+                       auto Products = getProducts(Current.Dotted.Rule);
+                       return Current.Dotted.Dot < Products.size() &&
+                              Products[Current.Dotted.Dot].isTerminal();
+                     });
+    if (ItReporting != Closure.end()) {
+      StateRules[State] = ItReporting->Dotted.Rule;
+    } else if (Closure.front().Dotted.Rule != AugmentedRule) {
+      StateRules[State] = Closure.front().Dotted.Rule;
+    }
+    for (auto &Current : Closure) {
+      if (Current.Dotted.Dot != getProducts(Current.Dotted.Rule).size()) {
+        continue;
+      }
+      uint32_t Action = Current.Dotted.Rule == AugmentedRule
+                            ? AK_Accept
+                            : Current.Dotted.Rule << 2 | AK_Reduce;
+      for (size_t Column = 0; Column < ColumnsNumber; ++Column) {
+        if (Current.Lookaheads[Column]) {
+          setAction(State, Column, Action);
+        }
+      }
+    }
+  }
+}
+
+std::vector<LALRTable::LookaheadItem>
+LALRTable::getClosure(const LL1Table &First,
+                      std::vector<LookaheadItem> Kernel) const {
+  auto Closure = std::move(Kernel);
+  std::vector<uint32_t> RuleItems(Grammar.getRulesNumber(), None);
+  std::vector<size_t> Pending(Closure.size());
+  for (size_t I = 0; I < Pending.size(); ++I) {
+    Pending[I] = Pending.size() - I - 1;
+  }
+  std::vector<bool> Following;
+  while (!Pending.empty()) {
+    auto Current = Closure[Pending.back()].Dotted;
+    Following.assign(ColumnsNumber + 1, false);
+    auto Products = getProducts(Current.Rule);
+    if (Current.Dot == Products.size() ||
+        Products[Current.Dot].isTerminal()) {
+      Pending.pop_back();
+      continue;
+    }
+    if (First.addFirst(Products, Current.Dot + 1, Following)) {
+      mergeSets(Following, Closure[Pending.back()].Lookaheads);
+    }
+    Pending.pop_back();
+    auto [RulesBegin, RulesEnd] =
+        Grammar.getRules(Products[Current.Dot].getID());
+    for (size_t Rule = RulesBegin; Rule < RulesEnd; ++Rule) {
+      if (RuleItems[Rule] == None) {
+        RuleItems[Rule] = static_cast<uint32_t>(Closure.size());
+        Closure.push_back(
+            LookaheadItem{Item{static_cast<uint32_t>(Rule), 0}, Following});
+        Pending.push_back(RuleItems[Rule]);
+      } else if (mergeSets(Closure[RuleItems[Rule]].Lookaheads, Following)) {
+        Pending.push_back(RuleItems[Rule]);
+      }
+    }
+  }
+  return Closure;
+}
+
+ProductsRange LALRTable::getProducts(uint32_t Rule) const noexcept {
+  if (Rule == AugmentedRule) {
+    return ProductsRange(AugmentedProducts, AugmentedProducts + 1);
+  }
+  return Grammar.getProducts(Rule);
+}
+
+uint32_t LALRTable::getNextKernelItem(uint32_t State, Item Dotted) const {
+  auto Next = getProducts(Dotted.Rule)[Dotted.Dot];
+  uint32_t NextState =
+      Next.isTerminal()
+          ? getActionValue(Actions[State * ColumnsNumber + Next.getID() + 1])
+          : Gotos[State * NonTerminalsNumber + Next.getID()];
+  auto ItBegin = KernelItems.begin() + KernelOffsets[NextState];
+  auto ItEnd = KernelItems.begin() + KernelOffsets[NextState + 1];
+  auto ItNext =
+      std::lower_bound(ItBegin, ItEnd, Item{Dotted.Rule, Dotted.Dot + 1});
+  assert(ItNext != ItEnd && "Successor should have the next item in kernel");
+  return static_cast<uint32_t>(ItNext - KernelItems.begin());
+}
+
+void LALRTable::setAction(uint32_t State, size_t Column, uint32_t Action) {
+  auto &Cell = Actions[State * ColumnsNumber + Column];
+  if (Cell == AK_Error || Cell == Action) {
+    Cell = Action;
+    return;
+  }
+  int Lookahead = static_cast<int>(Column) - 1;
+  auto ItConflict = std::find_if(Conflicts.begin(), Conflicts.end(),
+                                 [State, Lookahead](const LALRConflict &C) {
+                                   return C.State == State &&
+                                          C.Lookahead == Lookahead;
+                                 });
+  if (ItConflict == Conflicts.end()) {
+    Conflicts.push_back(LALRConflict{State, Lookahead, false, {}});
+    ItConflict = std::prev(Conflicts.end());
+    if (getActionKind(Cell) == AK_Shift) {
+      ItConflict->Shift = true;
+    } else if (getActionKind(Cell) == AK_Reduce) {
+      ItConflict->Rules.push_back(Grammar.getRule(getActionValue(Cell)));
+    }
+  }
+  if (getActionKind(Action) == AK_Reduce) {
+    ItConflict->Rules.push_back(Grammar.getRule(getActionValue(Action)));
+  }
+  // Shifts take precedence, then rules added first. Acceptance has the
+  // lowest precedence, as the augmented rule is the last one.
+  if (getActionKind(Cell) == AK_Shift ||
+      (getActionKind(Cell) == AK_Reduce &&
+       (getActionKind(Action) == AK_Accept ||
+        getActionValue(Cell) < getActionValue(Action)))) {
+    return;
+  }
+  Cell = Action;
+}
+
+void LALRTable::fillData() {
+  ProductOffsets.push_back(0);
+  for (size_t Rule = 0; Rule < Grammar.getRulesNumber(); ++Rule) {
+    RuleNonTerminals.push_back(Grammar.getNonTerminalID(Rule));
+    for (auto &Product : Grammar.getProducts(Rule)) {
+      Products.push_back(encodeSymbol(Product));
+    }
+    ProductOffsets.push_back(static_cast<uint32_t>(Products.size()));
+  }
+  Data.StartNonTerminal = Grammar.getStartSymbol().getID();
+  Data.StatesNumber = static_cast<uint32_t>(KernelOffsets.size() - 1);
+  Data.ColumnsNumber = static_cast<uint32_t>(ColumnsNumber);
+  Data.NonTerminalsNumber = static_cast<uint32_t>(NonTerminalsNumber);
+  Data.RulesNumber = static_cast<uint32_t>(Grammar.getRulesNumber());
+  Data.ConflictsNumber = static_cast<uint32_t>(Conflicts.size());
+  Data.Actions = Actions.data();
+  Data.Gotos = Gotos.data();
+  Data.StateRules = StateRules.data();
+  Data.RuleNonTerminals = RuleNonTerminals.data();
+  Data.ProductOffsets = ProductOffsets.data();
+  Data.Products = Products.data();
+}
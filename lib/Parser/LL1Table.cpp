@@ -0,0 +1,169 @@
+#include "cowabunga/Parser/LL1Table.h"
+
+#include <algorithm>
+#include <cassert>
+
+using namespace cb;
+
+namespace {
+
+/// Adds elements of From to To. Returns true if To has changed.
+bool mergeSets(std::vector<bool> &To, const std::vector<bool> &From) {
+  bool Changed = false;
+  for (size_t I = 0; I < From.size(); ++I) {
+    if (From[I] && !To[I]) {
+      To[I] = true;
+      Changed = true;
+    }
+  }
+  return Changed;
+}
+
+} // namespace
+
+LL1Table::LL1Table(const GrammarIndex &GrammarRules)
+    : Grammar(GrammarRules), ColumnsNumber(Grammar.getTerminalsNumber() + 1) {
+  computeNullable();
+  computeFirst();
+  computeFollow();
+  buildTable();
+}
+
+const std::vector<size_t> &LL1Table::getPredictedRules(int NonTerminalID,
+                                                       int Lookahead) const {
+  static const std::vector<size_t> NoRules;
+  size_t Column = getColumn(Lookahead);
+  if (NonTerminalID < 0 ||
+      static_cast<size_t>(NonTerminalID) >= Grammar.getNonTerminalsNumber() ||
+      Column == ColumnsNumber) {
+    return NoRules;
+  }
+  return Cells[NonTerminalID * ColumnsNumber + Column];
+}
+
+bool LL1Table::predicts(size_t Rule, int Lookahead) const {
+  assert(Rule < RuleLookaheads.size() && "Unknown rule");
+  size_t Column = getColumn(Lookahead);
+  return Column != ColumnsNumber && RuleLookaheads[Rule][Column];
+}
+
+bool LL1Table::isNullable(int NonTerminalID) const {
+  return NonTerminalID >= 0 &&
+         static_cast<size_t>(NonTerminalID) < Nullable.size() &&
+         Nullable[NonTerminalID];
+}
+
+bool LL1Table::isLL1() const noexcept { return Conflicts.empty(); }
+
+const std::vector<LL1Conflict> &LL1Table::getConflicts() const noexcept {
+  return Conflicts;
+}
+
+void LL1Table::computeNullable() {
+  Nullable.assign(Grammar.getNonTerminalsNumber(), false);
+  for (bool Changed = true; Changed;) {
+    Changed = false;
+    for (size_t I = 0; I < Grammar.getRulesNumber(); ++I) {
+      if (Nullable[Grammar.getNonTerminalID(I)]) {
+        continue;
+      }
+      auto Products = Grammar.getProducts(I);
+      if (std::all_of(Products.begin(), Products.end(),
+                      [this](const Symbol &Product) {
+                        return Product.isNonTerminal() &&
+                               Nullable[Product.getID()];
+                      })) {
+        Nullable[Grammar.getNonTerminalID(I)] = true;
+        Changed = true;
+      }
+    }
+  }
+}
+
+void LL1Table::computeFirst() {
+  First.assign(Grammar.getNonTerminalsNumber(),
+               std::vector<bool>(ColumnsNumber));
+  for (bool Changed = true; Changed;) {
+    Changed = false;
+    for (size_t I = 0; I < Grammar.getRulesNumber(); ++I) {
+      std::vector<bool> RuleFirst(ColumnsNumber);
+      addFirst(Grammar.getProducts(I), 0, RuleFirst);
+      Changed |= mergeSets(First[Grammar.getNonTerminalID(I)], RuleFirst);
+    }
+  }
+}
+
+void LL1Table::computeFollow() {
+  Follow.assign(Grammar.getNonTerminalsNumber(),
+                std::vector<bool>(ColumnsNumber));
+  Follow[Grammar.getStartSymbol().getID()][getColumn(EndOfInput)] = true;
+  for (bool Changed = true; Changed;) {
+    Changed = false;
+    for (size_t I = 0; I < Grammar.getRulesNumber(); ++I) {
+      auto Products = Grammar.getProducts(I);
+      for (size_t J = 0; J < Products.size(); ++J) {
+        if (Products[J].isTerminal()) {
+          continue;
+        }
+        std::vector<bool> ProductFollow(ColumnsNumber);
+        if (addFirst(Products, J + 1, ProductFollow)) {
+          mergeSets(ProductFollow, Follow[Grammar.getNonTerminalID(I)]);
+        }
+        Changed |= mergeSets(Follow[Products[J].getID()], ProductFollow);
+      }
+    }
+  }
+}
+
+void LL1Table::buildTable() {
+  Cells.assign(Grammar.getNonTerminalsNumber() * ColumnsNumber, {});
+  RuleLookaheads.assign(Grammar.getRulesNumber(),
+                        std::vector<bool>(ColumnsNumber));
+  for (size_t I = 0; I < Grammar.getRulesNumber(); ++I) {
+    auto &Lookaheads = RuleLookaheads[I];
+    if (addFirst(Grammar.getProducts(I), 0, Lookaheads)) {
+      mergeSets(Lookaheads, Follow[Grammar.getNonTerminalID(I)]);
+    }
+    size_t Row = Grammar.getNonTerminalID(I) * ColumnsNumber;
+    for (size_t Column = 0; Column < ColumnsNumber; ++Column) {
+      if (Lookaheads[Column]) {
+        Cells[Row + Column].push_back(I);
+      }
+    }
+  }
+  for (size_t Cell = 0; Cell < Cells.size(); ++Cell) {
+    if (Cells[Cell].size() < 2) {
+      continue;
+    }
+    LL1Conflict Conflict;
+    Conflict.NonTerminal = nonTerminal(static_cast<int>(Cell / ColumnsNumber));
+    Conflict.Lookahead = static_cast<int>(Cell % ColumnsNumber) - 1;
+    for (size_t Rule : Cells[Cell]) {
+      Conflict.Rules.push_back(Grammar.getRule(Rule));
+    }
+    Conflicts.push_back(std::move(Conflict));
+  }
+}
+
+bool LL1Table::addFirst(ProductsRange Products, size_t Begin,
+                        std::vector<bool> &Set) const {
+  for (size_t I = Begin; I < Products.size(); ++I) {
+    if (Products[I].isTerminal()) {
+      Set[getColumn(Products[I].getID())] = true;
+      return false;
+    }
+    mergeSets(Set, First[Products[I].getID()]);
+    if (!Nullable[Products[I].getID()]) {
+      return false;
+    }
+  }
+  return true;
+}
+
+size_t LL1Table::getColumn(int Lookahead) const noexcept {
+  if (Lookahead < EndOfInput ||
+      static_cast<size_t>(Lookahead) + 1 >= ColumnsNumber) {
+    return ColumnsNumber;
+  }
+  return Lookahead + 1;
+}
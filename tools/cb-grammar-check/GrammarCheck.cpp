@@ -0,0 +1,189 @@
+#include "cowabunga/CBC/ASTBuilder.h"
+#include "cowabunga/CBC/Parsers.h"
+#include "cowabunga/Lexer/Lexer.h"
+#include "cowabunga/Lexer/SymbolTable.h"
+#include "cowabunga/Parser/CFGParser.h"
+#include "cowabunga/Parser/GrammarAnalysis.h"
+#include "cowabunga/Parser/Symbol.h"
+
+#include <iostream>
+#include <iterator>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+using namespace cb;
+
+namespace {
+
+/// Names of NonTerminalID values.
+const char *const NonTerminalNames[] = {"TopLevelExpression",
+                                        "CompoundExpression",
+                                        "Expression",
+                                        "RValue",
+                                        "LValue",
+                                        "ParamList"};
+
+const char *const ComplexityNames[] = {"linear", "cubic", "exponential",
+                                       "non-terminating"};
+
+void printSymbol(std::ostream &Out, Symbol Sym, const Lexer &Lex) {
+  if (Sym.isTerminal()) {
+    Out << Lex.getTokenLexeme(Sym.getID());
+  } else if (static_cast<size_t>(Sym.getID()) <
+             std::size(NonTerminalNames)) {
+    Out << NonTerminalNames[Sym.getID()];
+  } else {
+    Out << "N" << Sym.getID();
+  }
+}
+
+void printLookahead(std::ostream &Out, int Lookahead, const Lexer &Lex) {
+  if (Lookahead == LL1Table::EndOfInput) {
+    Out << "EOF";
+  } else {
+    printSymbol(Out, terminal(Lookahead), Lex);
+  }
+}
+
+void printRule(std::ostream &Out, const ICFGRule &Rule, const Lexer &Lex) {
+  Out << "    ";
+  printSymbol(Out, Rule.getLHSNonTerminal(), Lex);
+  Out << " ->";
+  for (auto &Product : Rule.getProducts()) {
+    Out << " ";
+    printSymbol(Out, Product, Lex);
+  }
+  Out << "\n";
+}
+
+void printNonTerminals(std::ostream &Out, std::string_view Title,
+                       const std::vector<Symbol> &NonTerminals,
+                       const Lexer &Lex) {
+  Out << Title << ":";
+  if (NonTerminals.empty()) {
+    Out << " none";
+  }
+  for (auto &NonTerminal : NonTerminals) {
+    Out << " ";
+    printSymbol(Out, NonTerminal, Lex);
+  }
+  Out << "\n";
+}
+
+void printConflicts(std::ostream &Out, std::string_view Title,
+                    const std::vector<LL1Conflict> &Conflicts,
+                    const Lexer &Lex) {
+  Out << Title << ":" << (Conflicts.empty() ? " none" : "") << "\n";
+  for (auto &Conflict : Conflicts) {
+    Out << "  ";
+    printSymbol(Out, Conflict.NonTerminal, Lex);
+    Out << " on ";
+    printLookahead(Out, Conflict.Lookahead, Lex);
+    Out << ":\n";
+    for (auto *Rule : Conflict.Rules) {
+      printRule(Out, *Rule, Lex);
+    }
+  }
+}
+
+void printConflicts(std::ostream &Out, std::string_view Title,
+                    const std::vector<LALRConflict> &Conflicts,
+                    const Lexer &Lex) {
+  Out << Title << ":" << (Conflicts.empty() ? " none" : "") << "\n";
+  for (auto &Conflict : Conflicts) {
+    Out << "  state " << Conflict.State << " on ";
+    printLookahead(Out, Conflict.Lookahead, Lex);
+    Out << ":" << (Conflict.Shift ? " shift or reduce" : " reduce") << "\n";
+    for (auto *Rule : Conflict.Rules) {
+      printRule(Out, *Rule, Lex);
+    }
+  }
+}
+
+std::optional<CFGParserAlgorithm> parseAlgorithm(std::string_view Name) {
+  if (Name == "backtracking") {
+    return CFGParserAlgorithm::Backtracking;
+  }
+  if (Name == "earley") {
+    return CFGParserAlgorithm::Earley;
+  }
+  if (Name == "lalr") {
+    return CFGParserAlgorithm::LALR;
+  }
+  return std::nullopt;
+}
+
+std::optional<GrammarComplexity> parseComplexity(std::string_view Name) {
+  for (size_t I = 0; I < std::size(ComplexityNames); ++I) {
+    if (Name == ComplexityNames[I]) {
+      return static_cast<GrammarComplexity>(I);
+    }
+  }
+  return std::nullopt;
+}
+
+} // namespace
+
+int main(int argc, char **argv) {
+  auto Algorithm = CFGParserAlgorithm::LALR;
+  std::optional<GrammarComplexity> MaxComplexity;
+  for (int I = 1; I < argc; ++I) {
+    std::string_view Arg = argv[I];
+    std::string_view AlgorithmOption = "--algorithm=";
+    std::string_view MaxComplexityOption = "--max-complexity=";
+    std::optional<CFGParserAlgorithm> NewAlgorithm;
+    if (Arg.substr(0, AlgorithmOption.size()) == AlgorithmOption &&
+        (NewAlgorithm = parseAlgorithm(Arg.substr(AlgorithmOption.size())))) {
+      Algorithm = *NewAlgorithm;
+    } else if (Arg.substr(0, MaxComplexityOption.size()) ==
+                   MaxComplexityOption &&
+               (MaxComplexity = parseComplexity(
+                    Arg.substr(MaxComplexityOption.size())))) {
+      continue;
+    } else {
+      std::cerr << "Usage: cb-grammar-check "
+                   "[--algorithm=backtracking|earley|lalr] "
+                   "[--max-complexity=linear|cubic|exponential]"
+                << std::endl;
+      return 1;
+    }
+  }
+
+  Lexer Lex = createScriptLexer();
+  SymbolTable Symbols;
+  ASTBuilder Builder(Lex.getSourceManager(), Symbols);
+  auto Parser = createScriptParser(Lex, Builder);
+  auto &Grammar = Parser.getGrammarIndex();
+  GrammarAnalysis Analysis(Grammar);
+
+  std::cout << "Script grammar: " << Grammar.getRulesNumber() << " rules\n";
+  printNonTerminals(std::cout, "Left-recursive nonterminals",
+                    Analysis.getLeftRecursive(), Lex);
+  printNonTerminals(std::cout, "Unreachable nonterminals",
+                    Analysis.getUnreachable(), Lex);
+  printNonTerminals(std::cout, "Non-productive nonterminals",
+                    Analysis.getNonProductive(), Lex);
+  printConflicts(std::cout, "FIRST/FIRST conflicts",
+                 Analysis.getFirstFirstConflicts(), Lex);
+  printConflicts(std::cout, "FIRST/FOLLOW conflicts",
+                 Analysis.getFirstFollowConflicts(), Lex);
+  printConflicts(std::cout, "LALR(1) conflicts", Analysis.getLALRConflicts(),
+                 Lex);
+  const char *AmbiguityNames[] = {"no", "yes", "unknown"};
+  std::cout << "Ambiguous: "
+            << AmbiguityNames[static_cast<int>(Analysis.getAmbiguity())]
+            << "\n";
+  auto Complexity = Analysis.getComplexity(Algorithm);
+  std::cout << "Worst-case parsing time: "
+            << ComplexityNames[static_cast<int>(Complexity)] << std::endl;
+
+  if (MaxComplexity && Complexity > *MaxComplexity) {
+    std::cerr << "Parsing time of the script grammar exceeds "
+              << ComplexityNames[static_cast<int>(*MaxComplexity)] << "."
+              << std::endl;
+    return 2;
+  }
+  return 0;
+}
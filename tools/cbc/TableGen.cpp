@@ -0,0 +1,31 @@
+#include "cowabunga/CBC/ASTBuilder.h"
+#include "cowabunga/CBC/Parsers.h"
+#include "cowabunga/Lexer/Lexer.h"
+#include "cowabunga/Lexer/SymbolTable.h"
+#include "cowabunga/Parser/CFGParser.h"
+
+#include <fstream>
+#include <iostream>
+
+using namespace cb;
+
+int main(int argc, char **argv) {
+  if (argc != 2) {
+    std::cerr << "Usage: cbc-tablegen <output file>" << std::endl;
+    return 1;
+  }
+  Lexer Lex;
+  SymbolTable Symbols;
+  ASTBuilder Builder(Lex.getSourceManager(), Symbols);
+  auto Parser = createScriptParser(Lex, Builder);
+  std::ofstream Output(argv[1]);
+  if (!Output) {
+    std::cerr << "Can't open " << argv[1] << "." << std::endl;
+    return 2;
+  }
+  if (!Parser.writeLALRTable(Output, "ScriptParseTable")) {
+    std::cerr << "Script grammar isn't LALR(1)." << std::endl;
+    return 3;
+  }
+  return 0;
+}
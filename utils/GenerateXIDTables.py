@@ -0,0 +1,65 @@
+#!/usr/bin/env python3
+"""Generates lib/Lexer/XIDTables.inc, the lookup table of Unicode XID_Start
+and XID_Continue properties used by identifier tokenizers.
+
+Code points are split into blocks of 256. Every distinct block is stored once
+as two 256-bit sets, XID_Start followed by XID_Continue, and XIDBlockIndex maps
+the upper bits of a code point to its block.
+
+Usage: utils/GenerateXIDTables.py > lib/Lexer/XIDTables.inc
+"""
+
+import sys
+import unicodedata
+
+BLOCK_SIZE = 256
+MAX_CODE_POINT = 0x110000
+
+
+def is_xid_start(code_point):
+    char = chr(code_point)
+    return char != "_" and char.isidentifier()
+
+
+def is_xid_continue(code_point):
+    return ("a" + chr(code_point)).isidentifier()
+
+
+def bitset_words(predicate, first):
+    words = []
+    for word in range(BLOCK_SIZE // 64):
+        value = 0
+        for bit in range(64):
+            if predicate(first + word * 64 + bit):
+                value |= 1 << bit
+        words.append(value)
+    return words
+
+
+def main():
+    blocks = {}
+    block_index = []
+    for first in range(0, MAX_CODE_POINT, BLOCK_SIZE):
+        block = tuple(bitset_words(is_xid_start, first) +
+                      bitset_words(is_xid_continue, first))
+        block_index.append(blocks.setdefault(block, len(blocks)))
+    assert len(blocks) <= 256, "block numbers don't fit into uint8_t"
+
+    out = sys.stdout
+    out.write("// Generated by utils/GenerateXIDTables.py from Unicode %s "
+              "data. Don't edit.\n\n" % unicodedata.unidata_version)
+    out.write("constexpr uint8_t XIDBlockIndex[%d] = {\n" % len(block_index))
+    for row in range(0, len(block_index), 16):
+        out.write("    " + ", ".join(
+            str(index) for index in block_index[row:row + 16]) + ",\n")
+    out.write("};\n\n")
+    out.write("constexpr uint64_t XIDBlocks[%d][%d] = {\n" %
+              (len(blocks), BLOCK_SIZE // 32))
+    for block in sorted(blocks, key=blocks.get):
+        out.write("    {" + ", ".join("0x%016xULL" % word for word in block) +
+                  "},\n")
+    out.write("};\n")
+
+
+if __name__ == "__main__":
+    main()